@@ -3,84 +3,255 @@
 #include <zephyr/drivers/i2c.h>
 #include <zephyr/kernel.h>
 #include <zephyr/sys/printk.h>
+#include "../i2c/i2c_engine.h"
 
 #define CCS811_STATUS_REGISTER 0x00
 #define CCS811_APP_START 0xF4
 #define CCS811_MEAS_MODE 0x01
+#define CCS811_ALG_RESULT_DATA 0x02
+#define CCS811_RAW_DATA 0x03
+#define CCS811_ENV_DATA 0x05
+#define CCS811_THRESHOLDS 0x10
+#define CCS811_BASELINE 0x11
 
-int ccs811_init(struct ccs811_data *data, const struct device *i2c_dev, uint8_t address)
+#define CCS811_MEAS_MODE_DRIVE_MODE(mode) ((mode) << 4)
+
+/* Time the sensor takes to boot the application after APP_START */
+#define CCS811_APP_START_MS 100
+
+static int ccs811_reg_read(struct ccs811_data *data, uint8_t reg, uint8_t *buf, size_t len)
+{
+    return i2c_engine_write_read(data->bus, data->address, &reg, 1, buf, len);
+}
+
+uint32_t ccs811_drive_mode_period_ms(enum ccs811_drive_mode mode)
+{
+    switch (mode)
+    {
+    case CCS811_DRIVE_MODE_1S:
+        return 1000;
+    case CCS811_DRIVE_MODE_10S:
+        return 10000;
+    case CCS811_DRIVE_MODE_60S:
+        return 60000;
+    case CCS811_DRIVE_MODE_250MS:
+        return 250;
+    default:
+        return 0;
+    }
+}
+
+int ccs811_set_drive_mode(struct ccs811_data *data, enum ccs811_drive_mode mode,
+                          uint8_t interrupts)
+{
+    uint8_t meas_mode[2] = {CCS811_MEAS_MODE,
+                            CCS811_MEAS_MODE_DRIVE_MODE(mode) |
+                                (interrupts & (CCS811_INT_DATARDY | CCS811_INT_THRESH))};
+
+    if (mode > CCS811_DRIVE_MODE_250MS)
+    {
+        return -EINVAL;
+    }
+    if (i2c_engine_write(data->bus, data->address, meas_mode, sizeof(meas_mode)) < 0)
+    {
+        printk("Failed to set measurement mode\n");
+        return -EIO;
+    }
+    data->meas_mode = meas_mode[1];
+    return 0;
+}
+
+int ccs811_set_thresholds(struct ccs811_data *data, uint16_t low_to_med,
+                          uint16_t med_to_high, uint8_t hysteresis)
+{
+    uint8_t thresholds[] = {CCS811_THRESHOLDS, low_to_med >> 8, low_to_med & 0xFF,
+                            med_to_high >> 8, med_to_high & 0xFF, hysteresis};
+
+    if (i2c_engine_write(data->bus, data->address, thresholds, sizeof(thresholds)) < 0)
+    {
+        printk("Failed to set thresholds\n");
+        return -EIO;
+    }
+    return 0;
+}
+
+/* ENV_DATA holds both values in 1/512 units, the temperature offset by 25 °C */
+static uint16_t ccs811_env_value(int32_t milli)
+{
+    int64_t value = ((int64_t)milli * 512 + 500) / 1000;
+
+    return CLAMP(value, 0, UINT16_MAX);
+}
+
+int ccs811_set_env_data(struct ccs811_data *data, int32_t temperature_m_deg_c,
+                        int32_t humidity_m_percent_rh)
+{
+    uint16_t humidity = ccs811_env_value(humidity_m_percent_rh);
+    uint16_t temperature = ccs811_env_value(temperature_m_deg_c + 25000);
+    uint8_t env_data[] = {CCS811_ENV_DATA, humidity >> 8, humidity & 0xFF,
+                          temperature >> 8, temperature & 0xFF};
+
+    if (i2c_engine_write(data->bus, data->address, env_data, sizeof(env_data)) < 0)
+    {
+        printk("Failed to write environment data\n");
+        return -EIO;
+    }
+    return 0;
+}
+
+int ccs811_read_baseline(struct ccs811_data *data, uint16_t *baseline)
+{
+    uint8_t buffer[2];
+    if (ccs811_reg_read(data, CCS811_BASELINE, buffer, 2) < 0)
+    {
+        printk("Failed to read baseline\n");
+        return -EIO;
+    }
+
+    *baseline = ((uint16_t)buffer[0] << 8) | buffer[1];
+
+    return 0;
+}
+
+int ccs811_write_baseline(struct ccs811_data *data, uint16_t baseline)
+{
+    uint8_t buffer[] = {CCS811_BASELINE, baseline >> 8, baseline & 0xFF};
+
+    if (i2c_engine_write(data->bus, data->address, buffer, sizeof(buffer)) < 0)
+    {
+        printk("Failed to write baseline\n");
+        return -EIO;
+    }
+    return 0;
+}
+
+int ccs811_app_start(struct ccs811_data *data, struct i2c_bus *bus, uint8_t address)
 {
-    data->i2c_dev = i2c_dev;
+    data->bus = bus;
     data->address = address;
+    data->app_start_at = 0;
 
     uint8_t status;
 
-    if (i2c_reg_read_byte(data->i2c_dev, data->address, CCS811_STATUS_REGISTER, &status) < 0)
+    if (ccs811_reg_read(data, CCS811_STATUS_REGISTER, &status, 1) < 0)
     {
         printk("Failed to read status register\n");
         return -EIO;
     }
     printk("Initial status: 0x%x\n", status);
 
-    if ((status & 0x10) == 0)
+    if ((status & CCS811_STATUS_APP_VALID) == 0)
     {
         printk("Sensor is not in boot mode\n");
         return -EIO;
     }
 
     uint8_t app_start_cmd = CCS811_APP_START;
-    if (i2c_write(data->i2c_dev, &app_start_cmd, 1, data->address) < 0)
+    if (i2c_engine_write(data->bus, data->address, &app_start_cmd, 1) < 0)
     {
         printk("Failed to send application start command\n");
         return -EIO;
     }
 
-    k_sleep(K_MSEC(100));
+    data->app_start_at = k_uptime_get() + CCS811_APP_START_MS;
+    return 0;
+}
+
+int32_t ccs811_app_ms_until_started(struct ccs811_data *data)
+{
+    int64_t wait = data->app_start_at - k_uptime_get();
+
+    return data->app_start_at != 0 && wait > 0 ? (int32_t)wait : 0;
+}
+
+int ccs811_app_started(struct ccs811_data *data, enum ccs811_drive_mode mode,
+                       uint8_t interrupts)
+{
+    uint8_t status;
 
-    if (i2c_reg_read_byte(data->i2c_dev, data->address, CCS811_STATUS_REGISTER, &status) < 0)
+    if (data->app_start_at == 0)
+    {
+        return -EINVAL;
+    }
+    if (ccs811_app_ms_until_started(data) > 0)
+    {
+        return -EAGAIN;
+    }
+    data->app_start_at = 0;
+
+    if (ccs811_reg_read(data, CCS811_STATUS_REGISTER, &status, 1) < 0)
     {
         printk("Failed to read status after app start\n");
         return -EIO;
     }
     printk("Status after app start: 0x%x\n", status);
 
-    if ((status & 0x80) == 0)
+    if ((status & CCS811_STATUS_FW_MODE) == 0)
     {
         printk("Sensor failed to start application mode\n");
         return -EIO;
     }
 
-    uint8_t meas_mode[] = {CCS811_MEAS_MODE, 0x10}; // Drive Mode 1 (constant power mode, measurement every second)
-    if (i2c_write(data->i2c_dev, meas_mode, sizeof(meas_mode), data->address) < 0)
+    return ccs811_set_drive_mode(data, mode, interrupts);
+}
+
+int ccs811_data_ready(struct ccs811_data *data, bool *ready)
+{
+    uint8_t status;
+    if (ccs811_reg_read(data, CCS811_STATUS_REGISTER, &status, 1) < 0)
     {
-        printk("Failed to set measurement mode\n");
+        printk("Failed to read status for data ready check\n");
         return -EIO;
     }
+    *ready = (status & CCS811_STATUS_DATA_READY);
     return 0;
 }
 
-bool ccs811_data_ready(struct ccs811_data *data)
+int ccs811_read_result(struct ccs811_data *data, struct ccs811_result *result)
 {
-    uint8_t status;
-    if (i2c_reg_read_byte(data->i2c_dev, data->address, CCS811_STATUS_REGISTER, &status) < 0)
+    uint8_t buffer[8];
+    if (ccs811_reg_read(data, CCS811_ALG_RESULT_DATA, buffer, 8) < 0)
     {
-        printk("Failed to read status for data ready check\n");
-        return false;
+        printk("Failed to read sensor data\n");
+        return -EIO;
     }
-    return (status & 0x08);
+
+    result->eco2 = ((uint16_t)buffer[0] << 8) | buffer[1];
+    result->tvoc = ((uint16_t)buffer[2] << 8) | buffer[3];
+    result->status = buffer[4];
+    result->error_id = buffer[5];
+    result->current_ua = buffer[6] >> 2;
+    result->adc = ((uint16_t)(buffer[6] & 0x03) << 8) | buffer[7];
+
+    return 0;
 }
 
 int ccs811_read(struct ccs811_data *data, uint16_t *eco2, uint16_t *tvoc)
 {
-    uint8_t buffer[5];
-    if (i2c_burst_read(data->i2c_dev, data->address, 0x02, buffer, 5) < 0)
+    struct ccs811_result result;
+    int ret = ccs811_read_result(data, &result);
+
+    if (ret < 0)
     {
-        printk("Failed to read sensor data\n");
+        return ret;
+    }
+    *eco2 = result.eco2;
+    *tvoc = result.tvoc;
+
+    return 0;
+}
+
+int ccs811_read_raw(struct ccs811_data *data, uint8_t *current_ua, uint16_t *adc)
+{
+    uint8_t buffer[2];
+    if (ccs811_reg_read(data, CCS811_RAW_DATA, buffer, 2) < 0)
+    {
+        printk("Failed to read raw data\n");
         return -EIO;
     }
 
-    *eco2 = ((uint16_t)buffer[0] << 8) | buffer[1];
-    *tvoc = ((uint16_t)buffer[2] << 8) | buffer[3];
+    *current_ua = buffer[0] >> 2;
+    *adc = ((uint16_t)(buffer[0] & 0x03) << 8) | buffer[1];
 
     return 0;
 }
@@ -3,15 +3,147 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
+#include "../i2c/i2c_bus.h"
+
+/* Interrupts signalled on nINT, ORed into the interrupts argument */
+#define CCS811_INT_DATARDY BIT(3)
+#define CCS811_INT_THRESH BIT(2)
+
+/* STATUS register */
+#define CCS811_STATUS_ERROR BIT(0)
+#define CCS811_STATUS_DATA_READY BIT(3)
+#define CCS811_STATUS_APP_VALID BIT(4)
+#define CCS811_STATUS_FW_MODE BIT(7)
+
+/* ERROR_ID register */
+#define CCS811_ERROR_WRITE_REG_INVALID BIT(0)
+#define CCS811_ERROR_READ_REG_INVALID BIT(1)
+#define CCS811_ERROR_MEASMODE_INVALID BIT(2)
+#define CCS811_ERROR_MAX_RESISTANCE BIT(3)
+#define CCS811_ERROR_HEATER_FAULT BIT(4)
+#define CCS811_ERROR_HEATER_SUPPLY BIT(5)
+
+/*
+ * Measurement drive modes. Mode 4 only updates RAW_DATA, not the eCO2 and
+ * TVOC results. Before switching to a mode with a lower sample rate the
+ * sensor has to stay in idle for at least 10 minutes.
+ */
+enum ccs811_drive_mode
+{
+    CCS811_DRIVE_MODE_IDLE = 0,
+    CCS811_DRIVE_MODE_1S = 1,    /* constant power */
+    CCS811_DRIVE_MODE_10S = 2,   /* pulse heating */
+    CCS811_DRIVE_MODE_60S = 3,   /* low power pulse heating */
+    CCS811_DRIVE_MODE_250MS = 4, /* constant power, raw data only */
+};
+
+/* The whole ALG_RESULT_DATA block */
+struct ccs811_result
+{
+    uint16_t eco2; /* ppm */
+    uint16_t tvoc; /* ppb */
+    uint8_t status;
+    uint8_t error_id;
+    uint8_t current_ua; /* heater current */
+    uint16_t adc;       /* 10 bit voltage reading */
+};
 
 struct ccs811_data
 {
-    const struct device *i2c_dev;
+    struct i2c_bus *bus;
     uint8_t address;
+    uint8_t meas_mode;    /* MEAS_MODE register as last written */
+    int64_t app_start_at; /* uptime the application is up, 0 if not started */
 };
 
-int ccs811_init(struct ccs811_data *data, const struct device *i2c_dev, uint8_t address);
-bool ccs811_data_ready(struct ccs811_data *data);
+/**
+ * Start the application firmware. The sensor takes a while to boot it;
+ * nothing waits here, ccs811_app_started() completes the start afterwards.
+ *
+ * @returns 0 on success, negative errno otherwise
+ */
+int ccs811_app_start(struct ccs811_data *data, struct i2c_bus *bus, uint8_t address);
+
+/**
+ * Complete ccs811_app_start() and measure in the given drive mode.
+ *
+ * @param interrupts CCS811_INT_* to signal on nINT, 0 to poll the status
+ * @returns 0 on success, -EAGAIN while the application is still booting,
+ *          other negative errno otherwise
+ */
+int ccs811_app_started(struct ccs811_data *data, enum ccs811_drive_mode mode,
+                       uint8_t interrupts);
+
+/**
+ * @returns milliseconds until ccs811_app_started() can complete, 0 if it can
+ *          now or the application was not started
+ */
+int32_t ccs811_app_ms_until_started(struct ccs811_data *data);
+
+/**
+ * Change the drive mode and the interrupts signalled on nINT.
+ *
+ * @returns 0 on success, negative errno otherwise
+ */
+int ccs811_set_drive_mode(struct ccs811_data *data, enum ccs811_drive_mode mode,
+                          uint8_t interrupts);
+
+/**
+ * Set the eCO2 thresholds of CCS811_INT_THRESH. nINT is only asserted when
+ * a new result lies in a different range than the last one, by more than
+ * hysteresis ppm.
+ *
+ * @returns 0 on success, negative errno otherwise
+ */
+int ccs811_set_thresholds(struct ccs811_data *data, uint16_t low_to_med,
+                          uint16_t med_to_high, uint8_t hysteresis);
+
+/**
+ * Write the ambient temperature and humidity the eCO2 and TVOC results are
+ * compensated for. Without it the sensor assumes 25 °C and 50 %RH.
+ *
+ * @param temperature_m_deg_c Temperature in m°C, -25 °C at the least
+ * @param humidity_m_percent_rh Relative humidity in m%RH
+ * @returns 0 on success, negative errno otherwise
+ */
+int ccs811_set_env_data(struct ccs811_data *data, int32_t temperature_m_deg_c,
+                        int32_t humidity_m_percent_rh);
+
+/**
+ * Read the baseline the algorithm currently corrects the results with. The
+ * value is opaque; it is only meant to be written back with
+ * ccs811_write_baseline(), e.g. after a restart.
+ */
+int ccs811_read_baseline(struct ccs811_data *data, uint16_t *baseline);
+
+int ccs811_write_baseline(struct ccs811_data *data, uint16_t baseline);
+
+/**
+ * @returns milliseconds between two results in a drive mode, 0 in idle
+ */
+uint32_t ccs811_drive_mode_period_ms(enum ccs811_drive_mode mode);
+
+int ccs811_data_ready(struct ccs811_data *data, bool *ready);
+
+/**
+ * Read results, status, error and raw data in one 8 byte transfer. The
+ * sensor holds the last result until the next one; CCS811_STATUS_DATA_READY
+ * in the status tells whether it is new. Reading it clears the flag and
+ * deasserts nINT.
+ */
+int ccs811_read_result(struct ccs811_data *data, struct ccs811_result *result);
+
+/**
+ * Read the last eCO2 and TVOC result, see ccs811_read_result().
+ */
 int ccs811_read(struct ccs811_data *data, uint16_t *eco2, uint16_t *tvoc);
 
-#endif
\ No newline at end of file
+/**
+ * Read the raw sensor data, the only result updated in drive mode 4.
+ *
+ * @param current_ua Heater current in uA
+ * @param adc        10 bit voltage reading
+ */
+int ccs811_read_raw(struct ccs811_data *data, uint8_t *current_ua, uint16_t *adc);
+
+#endif
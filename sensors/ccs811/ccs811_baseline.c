@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/printk.h>
+#include "ccs811_baseline.h"
+
+/* Settings are kept in NVS on the storage partition, next to the
+ * OpenThread data set, one key per address: "ccs811/5a" */
+#define CCS811_BASELINE_SUBTREE "ccs811"
+#define CCS811_BASELINE_KEY_LEN sizeof(CCS811_BASELINE_SUBTREE "/5a")
+
+struct ccs811_baseline
+{
+    bool stored_valid;
+    uint16_t stored;    /* baseline in flash */
+    bool restored;      /* stored baseline written to the sensor */
+    int64_t started;    /* uptime in ms */
+    int64_t last_save;  /* uptime in ms, 0 if none since boot */
+    int64_t next_check; /* uptime in ms */
+};
+
+static uint32_t ccs811_baseline_save_interval_ms;
+static struct ccs811_baseline ccs811_baselines[CCS811_BASELINE_MAX];
+
+static struct ccs811_baseline *ccs811_baseline_get(uint16_t addr)
+{
+    if (addr < CCS811_BASELINE_ADDR_FIRST ||
+        addr >= CCS811_BASELINE_ADDR_FIRST + CCS811_BASELINE_MAX)
+    {
+        return NULL;
+    }
+    return &ccs811_baselines[addr - CCS811_BASELINE_ADDR_FIRST];
+}
+
+static int ccs811_baseline_set(const char *name, size_t len,
+                               settings_read_cb read_cb, void *cb_arg)
+{
+    struct ccs811_baseline *bl = ccs811_baseline_get(strtoul(name, NULL, 16));
+    uint16_t value;
+    ssize_t ret;
+
+    if (bl == NULL || len != sizeof(value))
+    {
+        return -ENOENT;
+    }
+    ret = read_cb(cb_arg, &value, sizeof(value));
+    if (ret < 0)
+    {
+        return ret;
+    }
+    bl->stored = value;
+    bl->stored_valid = true;
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(ccs811, CCS811_BASELINE_SUBTREE, NULL,
+                               ccs811_baseline_set, NULL, NULL);
+
+int ccs811_baseline_init(uint32_t save_interval_ms)
+{
+    int ret;
+
+    ccs811_baseline_save_interval_ms = save_interval_ms;
+    ret = settings_subsys_init();
+    if (ret != 0)
+    {
+        return ret;
+    }
+    ret = settings_load_subtree(CCS811_BASELINE_SUBTREE);
+    for (uint8_t i = 0; ret == 0 && i < CCS811_BASELINE_MAX; i++)
+    {
+        if (ccs811_baselines[i].stored_valid)
+        {
+            printk("CCS811 0x%02x baseline 0x%04x loaded\n",
+                   CCS811_BASELINE_ADDR_FIRST + i, ccs811_baselines[i].stored);
+        }
+    }
+    return ret;
+}
+
+void ccs811_baseline_start(const struct device *dev)
+{
+    struct ccs811_baseline *bl = ccs811_baseline_get(ccs811_sensor_addr(dev));
+
+    if (bl == NULL)
+    {
+        return;
+    }
+    bl->started = k_uptime_get();
+    bl->restored = false;
+    bl->next_check = bl->started + CCS811_BASELINE_RUN_IN_MS;
+}
+
+static bool ccs811_baseline_save_due(const struct ccs811_baseline *bl,
+                                     int64_t now)
+{
+    if (bl->last_save != 0)
+    {
+        return now - bl->last_save >= ccs811_baseline_save_interval_ms;
+    }
+    /* the first baseline after a boot comes from a conditioned sensor */
+    return now - bl->started >= ccs811_baseline_save_interval_ms;
+}
+
+int ccs811_baseline_update(const struct device *dev)
+{
+    uint16_t addr = ccs811_sensor_addr(dev);
+    struct ccs811_baseline *bl = ccs811_baseline_get(addr);
+    char key[CCS811_BASELINE_KEY_LEN];
+    int64_t now = k_uptime_get();
+    uint16_t baseline;
+    int ret;
+
+    if (bl == NULL)
+    {
+        return -EINVAL;
+    }
+    if (now < bl->next_check)
+    {
+        return 0;
+    }
+
+    if (!bl->restored && bl->stored_valid)
+    {
+        ret = ccs811_sensor_baseline_update(dev, bl->stored);
+        if (ret != 0)
+        {
+            return ret;
+        }
+        printk("CCS811 0x%02x baseline 0x%04x restored\n", addr, bl->stored);
+    }
+    bl->restored = true;
+    bl->next_check = now + CCS811_BASELINE_CHECK_MS;
+
+    if (!ccs811_baseline_save_due(bl, now))
+    {
+        return 0;
+    }
+    ret = ccs811_sensor_baseline_fetch(dev, &baseline);
+    if (ret != 0)
+    {
+        return ret;
+    }
+    if (bl->stored_valid && baseline == bl->stored)
+    {
+        return 0;
+    }
+    snprintf(key, sizeof(key), CCS811_BASELINE_SUBTREE "/%02x", addr);
+    ret = settings_save_one(key, &baseline, sizeof(baseline));
+    if (ret != 0)
+    {
+        return ret;
+    }
+    bl->stored = baseline;
+    bl->stored_valid = true;
+    bl->last_save = now;
+    printk("CCS811 0x%02x baseline 0x%04x stored\n", addr, baseline);
+    return 0;
+}
+
+int32_t ccs811_baseline_ms_until_due(const struct device *dev)
+{
+    struct ccs811_baseline *bl = ccs811_baseline_get(ccs811_sensor_addr(dev));
+    int64_t wait;
+
+    if (bl == NULL)
+    {
+        return 0;
+    }
+    wait = bl->next_check - k_uptime_get();
+    return wait > 0 ? (int32_t)wait : 0;
+}
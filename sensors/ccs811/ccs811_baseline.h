@@ -0,0 +1,45 @@
+#ifndef CCS811_BASELINE_H
+#define CCS811_BASELINE_H
+
+#include "ccs811_sensor.h"
+
+/* The sensor needs this long after every start before its baseline is
+ * written or read back. */
+#define CCS811_BASELINE_RUN_IN_MS (20 * 60 * 1000)
+/* Time between two checks of the baseline */
+#define CCS811_BASELINE_CHECK_MS (60 * 60 * 1000)
+/* One baseline per address, 0x5A and 0x5B */
+#define CCS811_BASELINE_ADDR_FIRST 0x5A
+#define CCS811_BASELINE_MAX 2
+
+/**
+ * Load the stored baselines. Call once at startup, before the first
+ * ccs811_baseline_start().
+ *
+ * @param save_interval_ms Minimum time between two flash writes; the first
+ *                         one is made after the sensor ran this long
+ * @returns 0 on success, negative errno otherwise
+ */
+int ccs811_baseline_init(uint32_t save_interval_ms);
+
+/**
+ * Restart the run-in after a sensor was (re)initialized.
+ */
+void ccs811_baseline_start(const struct device *dev);
+
+/**
+ * Restore the stored baseline once the run-in is over, then read the
+ * sensor's baseline and store it. Writes are coalesced: an unchanged
+ * baseline is never written, and a changed one at most once per save
+ * interval.
+ *
+ * @returns 0 on success, negative errno otherwise
+ */
+int ccs811_baseline_update(const struct device *dev);
+
+/**
+ * @returns milliseconds until ccs811_baseline_update() has work to do
+ */
+int32_t ccs811_baseline_ms_until_due(const struct device *dev);
+
+#endif
@@ -0,0 +1,433 @@
+#define DT_DRV_COMPAT ams_ccs811_app
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+#include <zephyr/sys/printk.h>
+#include "ccs811_sensor.h"
+
+/* Power-on values of the THRESHOLDS register */
+#define CCS811_SENSOR_LOW_TO_MED 1500
+#define CCS811_SENSOR_MED_TO_HIGH 2500
+#define CCS811_SENSOR_HYSTERESIS 50
+
+struct ccs811_sensor_config
+{
+    const struct device *bus_dev;
+    uint16_t addr;
+    struct gpio_dt_spec irq; /* nINT, port is NULL if not wired */
+    uint8_t drive_mode;
+};
+
+struct ccs811_sensor_data
+{
+    struct ccs811_data regs;
+    struct k_mutex lock;
+    bool started;
+    bool suspended;
+    bool has_result;
+    struct ccs811_result result;
+    uint8_t interrupts; /* CCS811_INT_* of the trigger that is set */
+    uint16_t low_to_med;
+    uint16_t med_to_high;
+    uint8_t hysteresis;
+    const struct device *dev;
+    struct gpio_callback irq_cb;
+    struct k_work irq_work;
+    sensor_trigger_handler_t handler;
+    const struct sensor_trigger *trigger;
+};
+
+static enum ccs811_drive_mode ccs811_sensor_mode(const struct device *dev)
+{
+    const struct ccs811_sensor_config *cfg = dev->config;
+    struct ccs811_sensor_data *data = dev->data;
+
+    return data->suspended ? CCS811_DRIVE_MODE_IDLE : cfg->drive_mode;
+}
+
+/* Rewrite MEAS_MODE and the thresholds of a running sensor; a stopped one
+ * picks them up when it is started. Called with the lock held. */
+static int ccs811_sensor_apply(const struct device *dev)
+{
+    struct ccs811_sensor_data *data = dev->data;
+    int ret;
+
+    if (!data->started)
+    {
+        return 0;
+    }
+    if (data->interrupts & CCS811_INT_THRESH)
+    {
+        ret = ccs811_set_thresholds(&data->regs, data->low_to_med, data->med_to_high,
+                                    data->hysteresis);
+        if (ret < 0)
+        {
+            return ret;
+        }
+    }
+    return ccs811_set_drive_mode(&data->regs, ccs811_sensor_mode(dev), data->interrupts);
+}
+
+int ccs811_sensor_start(const struct device *dev)
+{
+    const struct ccs811_sensor_config *cfg = dev->config;
+    struct ccs811_sensor_data *data = dev->data;
+    struct i2c_bus *bus = i2c_bus_find(cfg->bus_dev);
+    int ret;
+
+    if (bus == NULL)
+    {
+        return -ENODEV;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    ret = 0;
+    if (data->regs.app_start_at == 0)
+    {
+        data->started = false;
+        data->has_result = false;
+        ret = ccs811_app_start(&data->regs, bus, cfg->addr);
+    }
+    if (ret == 0)
+    {
+        ret = ccs811_app_started(&data->regs, CCS811_DRIVE_MODE_IDLE, 0);
+    }
+    if (ret == 0)
+    {
+        data->started = true;
+        ret = ccs811_sensor_apply(dev);
+    }
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+struct i2c_bus *ccs811_sensor_bus(const struct device *dev)
+{
+    const struct ccs811_sensor_config *cfg = dev->config;
+
+    return i2c_bus_find(cfg->bus_dev);
+}
+
+uint16_t ccs811_sensor_addr(const struct device *dev)
+{
+    const struct ccs811_sensor_config *cfg = dev->config;
+
+    return cfg->addr;
+}
+
+uint32_t ccs811_sensor_period_ms(const struct device *dev)
+{
+    const struct ccs811_sensor_config *cfg = dev->config;
+
+    return ccs811_drive_mode_period_ms(cfg->drive_mode);
+}
+
+void ccs811_sensor_result(const struct device *dev, struct ccs811_result *result)
+{
+    struct ccs811_sensor_data *data = dev->data;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    *result = data->result;
+    k_mutex_unlock(&data->lock);
+}
+
+bool ccs811_sensor_irq_pending(const struct device *dev)
+{
+    const struct ccs811_sensor_config *cfg = dev->config;
+
+    return cfg->irq.port != NULL && gpio_pin_get_dt(&cfg->irq) > 0;
+}
+
+int ccs811_sensor_env_update(const struct device *dev, int32_t temperature_m_deg_c,
+                             int32_t humidity_m_percent_rh)
+{
+    struct ccs811_sensor_data *data = dev->data;
+    int ret;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    ret = ccs811_set_env_data(&data->regs, temperature_m_deg_c, humidity_m_percent_rh);
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+int ccs811_sensor_baseline_fetch(const struct device *dev, uint16_t *baseline)
+{
+    struct ccs811_sensor_data *data = dev->data;
+    int ret;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    ret = ccs811_read_baseline(&data->regs, baseline);
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+int ccs811_sensor_baseline_update(const struct device *dev, uint16_t baseline)
+{
+    struct ccs811_sensor_data *data = dev->data;
+    int ret;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    ret = ccs811_write_baseline(&data->regs, baseline);
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+static int ccs811_sensor_sample_fetch(const struct device *dev, enum sensor_channel chan)
+{
+    struct ccs811_sensor_data *data = dev->data;
+    struct ccs811_result result;
+    int ret;
+
+    if (chan != SENSOR_CHAN_ALL && chan != SENSOR_CHAN_CO2 && chan != SENSOR_CHAN_VOC &&
+        chan != SENSOR_CHAN_VOLTAGE && chan != SENSOR_CHAN_CURRENT)
+    {
+        return -ENOTSUP;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    ret = ccs811_read_result(&data->regs, &result);
+    if (ret == 0)
+    {
+        data->result.status = result.status;
+        data->result.error_id = result.error_id;
+        if (result.status & CCS811_STATUS_ERROR)
+        {
+            printk("CCS811 0x%02x error 0x%02x\n", data->regs.address, result.error_id);
+            ret = -EIO;
+        }
+        else if (result.status & CCS811_STATUS_DATA_READY)
+        {
+            data->result = result;
+            data->has_result = true;
+        }
+        else if (!data->has_result)
+        {
+            ret = -ENODATA;
+        }
+    }
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+static int ccs811_sensor_channel_get(const struct device *dev, enum sensor_channel chan,
+                                     struct sensor_value *val)
+{
+    struct ccs811_sensor_data *data = dev->data;
+    struct ccs811_result result;
+    uint32_t micro;
+
+    ccs811_sensor_result(dev, &result);
+    switch (chan)
+    {
+    case SENSOR_CHAN_CO2:
+        val->val1 = result.eco2;
+        val->val2 = 0;
+        break;
+    case SENSOR_CHAN_VOC:
+        val->val1 = result.tvoc;
+        val->val2 = 0;
+        break;
+    case SENSOR_CHAN_VOLTAGE:
+        /* 1023 is 1.65 V */
+        micro = result.adc * 1650000U / 1023U;
+        val->val1 = micro / 1000000U;
+        val->val2 = micro % 1000000U;
+        break;
+    case SENSOR_CHAN_CURRENT:
+        val->val1 = 0;
+        val->val2 = result.current_ua;
+        break;
+    default:
+        return -ENOTSUP;
+    }
+    return data->has_result ? 0 : -ENODATA;
+}
+
+static int ccs811_sensor_attr_set(const struct device *dev, enum sensor_channel chan,
+                                  enum sensor_attribute attr, const struct sensor_value *val)
+{
+    struct ccs811_sensor_data *data = dev->data;
+    int ret;
+
+    if (chan != SENSOR_CHAN_CO2 || val->val1 < 0 || val->val1 > UINT16_MAX)
+    {
+        return -ENOTSUP;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    switch (attr)
+    {
+    case SENSOR_ATTR_LOWER_THRESH:
+        data->low_to_med = val->val1;
+        break;
+    case SENSOR_ATTR_UPPER_THRESH:
+        data->med_to_high = val->val1;
+        break;
+    case SENSOR_ATTR_HYSTERESIS:
+        data->hysteresis = MIN(val->val1, UINT8_MAX);
+        break;
+    default:
+        k_mutex_unlock(&data->lock);
+        return -ENOTSUP;
+    }
+    ret = ccs811_sensor_apply(dev);
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+static void ccs811_sensor_irq_handler(const struct device *port, struct gpio_callback *cb,
+                                      uint32_t pins)
+{
+    struct ccs811_sensor_data *data = CONTAINER_OF(cb, struct ccs811_sensor_data, irq_cb);
+
+    k_work_submit(&data->irq_work);
+}
+
+/* Trigger handlers run on the system work queue, so they may fetch */
+static void ccs811_sensor_irq_work(struct k_work *work)
+{
+    struct ccs811_sensor_data *data = CONTAINER_OF(work, struct ccs811_sensor_data, irq_work);
+    sensor_trigger_handler_t handler = data->handler;
+
+    if (handler != NULL)
+    {
+        handler(data->dev, data->trigger);
+    }
+}
+
+static int ccs811_sensor_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+                                     sensor_trigger_handler_t handler)
+{
+    const struct ccs811_sensor_config *cfg = dev->config;
+    struct ccs811_sensor_data *data = dev->data;
+    uint8_t interrupts = 0;
+    int ret;
+
+    if (cfg->irq.port == NULL)
+    {
+        return -ENOTSUP;
+    }
+    if (handler != NULL)
+    {
+        switch (trig->type)
+        {
+        case SENSOR_TRIG_DATA_READY:
+            interrupts = CCS811_INT_DATARDY;
+            break;
+        case SENSOR_TRIG_THRESHOLD:
+            interrupts = CCS811_INT_DATARDY | CCS811_INT_THRESH;
+            break;
+        default:
+            return -ENOTSUP;
+        }
+    }
+
+    ret = gpio_pin_interrupt_configure_dt(&cfg->irq, handler != NULL ? GPIO_INT_EDGE_TO_ACTIVE
+                                                                     : GPIO_INT_DISABLE);
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    data->handler = handler;
+    data->trigger = trig;
+    data->interrupts = interrupts;
+    ret = ccs811_sensor_apply(dev);
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+static const struct sensor_driver_api ccs811_sensor_api = {
+    .attr_set = ccs811_sensor_attr_set,
+    .trigger_set = ccs811_sensor_trigger_set,
+    .sample_fetch = ccs811_sensor_sample_fetch,
+    .channel_get = ccs811_sensor_channel_get,
+};
+
+#ifdef CONFIG_PM_DEVICE
+static int ccs811_sensor_pm_action(const struct device *dev, enum pm_device_action action)
+{
+    struct ccs811_sensor_data *data = dev->data;
+    int ret;
+
+    switch (action)
+    {
+    case PM_DEVICE_ACTION_SUSPEND:
+    case PM_DEVICE_ACTION_RESUME:
+        break;
+    default:
+        return -ENOTSUP;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    data->suspended = action == PM_DEVICE_ACTION_SUSPEND;
+    ret = ccs811_sensor_apply(dev);
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+#endif
+
+static int ccs811_sensor_init(const struct device *dev)
+{
+    const struct ccs811_sensor_config *cfg = dev->config;
+    struct ccs811_sensor_data *data = dev->data;
+    int ret;
+
+    data->dev = dev;
+    data->low_to_med = CCS811_SENSOR_LOW_TO_MED;
+    data->med_to_high = CCS811_SENSOR_MED_TO_HIGH;
+    data->hysteresis = CCS811_SENSOR_HYSTERESIS;
+    k_mutex_init(&data->lock);
+    k_work_init(&data->irq_work, ccs811_sensor_irq_work);
+
+    if (cfg->irq.port != NULL)
+    {
+        if (!gpio_is_ready_dt(&cfg->irq))
+        {
+            return -ENODEV;
+        }
+        ret = gpio_pin_configure_dt(&cfg->irq, GPIO_INPUT);
+        if (ret < 0)
+        {
+            return ret;
+        }
+        gpio_init_callback(&data->irq_cb, ccs811_sensor_irq_handler, BIT(cfg->irq.pin));
+        ret = gpio_add_callback_dt(&cfg->irq, &data->irq_cb);
+        if (ret < 0)
+        {
+            return ret;
+        }
+    }
+
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    /* idle until the first user takes it */
+    data->suspended = true;
+    pm_device_init_suspended(dev);
+    return pm_device_runtime_enable(dev);
+#else
+    return 0;
+#endif
+}
+
+#define CCS811_SENSOR(n)                                                                 \
+    BUILD_ASSERT(DT_INST_REG_ADDR(n) == 0x5A || DT_INST_REG_ADDR(n) == 0x5B,             \
+                 "CCS811 addresses are 0x5A (ADDR low) and 0x5B (ADDR high)");          \
+    static struct ccs811_sensor_data ccs811_sensor_data_##n;                             \
+    static const struct ccs811_sensor_config ccs811_sensor_config_##n = {                \
+        .bus_dev = DEVICE_DT_GET(DT_INST_BUS(n)),                                        \
+        .addr = DT_INST_REG_ADDR(n),                                                     \
+        .irq = GPIO_DT_SPEC_INST_GET_OR(n, irq_gpios, {0}),                              \
+        .drive_mode = DT_INST_PROP(n, drive_mode),                                       \
+    };                                                                                   \
+    PM_DEVICE_DT_INST_DEFINE(n, ccs811_sensor_pm_action);                                \
+    SENSOR_DEVICE_DT_INST_DEFINE(n, ccs811_sensor_init, PM_DEVICE_DT_INST_GET(n),        \
+                                 &ccs811_sensor_data_##n, &ccs811_sensor_config_##n,     \
+                                 POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY,               \
+                                 &ccs811_sensor_api);
+
+DT_INST_FOREACH_STATUS_OKAY(CCS811_SENSOR)
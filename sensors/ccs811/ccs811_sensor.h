@@ -0,0 +1,82 @@
+#ifndef CCS811_SENSOR_H
+#define CCS811_SENSOR_H
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+#include "ccs811.h"
+
+/*
+ * Sensor API driver for the "ams,ccs811-app" devicetree nodes, built on the
+ * register access in ccs811.c and the queued I2C engine.
+ *
+ * The device init only sets up the driver. The sensor itself is started by
+ * ccs811_sensor_start(), which the application calls at boot and again after
+ * the bus was reset, in line with its recovery policy.
+ *
+ * sample_fetch() reads results, status and error in one burst. It fails with
+ * -EIO if the sensor reports an error and with -ENODATA before the first
+ * result; otherwise the channels hold the latest result, which in the slow
+ * drive modes may be the one of an earlier fetch.
+ *
+ * Channels: SENSOR_CHAN_CO2 (eCO2 in ppm), SENSOR_CHAN_VOC (TVOC in ppb),
+ * SENSOR_CHAN_VOLTAGE and SENSOR_CHAN_CURRENT (raw heater measurement).
+ *
+ * Triggers need irq-gpios: SENSOR_TRIG_DATA_READY on every result,
+ * SENSOR_TRIG_THRESHOLD only when eCO2 moves to another range. The ranges
+ * are set with SENSOR_ATTR_LOWER_THRESH, SENSOR_ATTR_UPPER_THRESH and
+ * SENSOR_ATTR_HYSTERESIS on SENSOR_CHAN_CO2.
+ *
+ * With runtime PM, a suspended sensor idles in drive mode 0.
+ */
+
+/**
+ * Start the application firmware and measure in the devicetree drive mode,
+ * with the interrupts of the trigger that is set.
+ *
+ * The first call only sends APP_START and returns -EAGAIN; the firmware
+ * boots meanwhile and a later call completes the start. No thread waits.
+ *
+ * @returns 0 once started, -EAGAIN while the firmware boots, other negative
+ *          errno otherwise
+ */
+int ccs811_sensor_start(const struct device *dev);
+
+/**
+ * @returns the bus the sensor is on, NULL if it is not managed
+ */
+struct i2c_bus *ccs811_sensor_bus(const struct device *dev);
+
+/**
+ * @returns the 7-bit address of the sensor
+ */
+uint16_t ccs811_sensor_addr(const struct device *dev);
+
+/**
+ * @returns milliseconds between two results in the devicetree drive mode
+ */
+uint32_t ccs811_sensor_period_ms(const struct device *dev);
+
+/**
+ * Get the whole burst of the last fetch; its status tells whether the
+ * result was new (CCS811_STATUS_DATA_READY).
+ */
+void ccs811_sensor_result(const struct device *dev, struct ccs811_result *result);
+
+/**
+ * @returns true while nINT is asserted, i.e. a result waits to be fetched
+ */
+bool ccs811_sensor_irq_pending(const struct device *dev);
+
+/**
+ * Write the ambient temperature and humidity, see ccs811_set_env_data().
+ */
+int ccs811_sensor_env_update(const struct device *dev, int32_t temperature_m_deg_c,
+                             int32_t humidity_m_percent_rh);
+
+/**
+ * Read and write the baseline, see ccs811_read_baseline().
+ */
+int ccs811_sensor_baseline_fetch(const struct device *dev, uint16_t *baseline);
+int ccs811_sensor_baseline_update(const struct device *dev, uint16_t baseline);
+
+#endif
@@ -0,0 +1,394 @@
+#define DT_DRV_COMPAT ams_ccs811_emul
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/sys/byteorder.h>
+#include "emul_waveform.h"
+
+#define CCS811_EMUL_REG_STATUS 0x00
+#define CCS811_EMUL_REG_MEAS_MODE 0x01
+#define CCS811_EMUL_REG_ALG_RESULT_DATA 0x02
+#define CCS811_EMUL_REG_RAW_DATA 0x03
+#define CCS811_EMUL_REG_ENV_DATA 0x05
+#define CCS811_EMUL_REG_THRESHOLDS 0x10
+#define CCS811_EMUL_REG_BASELINE 0x11
+#define CCS811_EMUL_REG_HW_ID 0x20
+#define CCS811_EMUL_REG_HW_VERSION 0x21
+#define CCS811_EMUL_REG_FW_BOOT_VERSION 0x23
+#define CCS811_EMUL_REG_FW_APP_VERSION 0x24
+#define CCS811_EMUL_REG_ERROR_ID 0xE0
+#define CCS811_EMUL_REG_APP_START 0xF4
+#define CCS811_EMUL_REG_SW_RESET 0xFF
+
+#define CCS811_EMUL_STATUS_ERROR BIT(0)
+#define CCS811_EMUL_STATUS_DATA_READY BIT(3)
+#define CCS811_EMUL_STATUS_APP_VALID BIT(4)
+#define CCS811_EMUL_STATUS_FW_MODE BIT(7)
+
+#define CCS811_EMUL_ERROR_WRITE_REG_INVALID BIT(0)
+#define CCS811_EMUL_ERROR_READ_REG_INVALID BIT(1)
+#define CCS811_EMUL_ERROR_MEASMODE_INVALID BIT(2)
+
+#define CCS811_EMUL_HW_ID 0x81
+#define CCS811_EMUL_DRIVE_MODE(meas_mode) (((meas_mode) >> 4) & 0x07)
+#define CCS811_EMUL_MEAS_MODE_INT_DATARDY BIT(3)
+#define CCS811_EMUL_MEAS_MODE_INT_THRESH BIT(2)
+
+static const uint8_t ccs811_emul_reset_seq[] = {0x11, 0xE5, 0x72, 0x8A};
+
+struct ccs811_emul_cfg
+{
+    uint32_t data_ready_ms; /* sample period in drive mode 1 */
+    struct gpio_dt_spec irq; /* nINT, port is NULL if not wired */
+};
+
+struct ccs811_emul_data
+{
+    bool app_mode;
+    uint8_t reg; /* register pointer set by the last write */
+    uint8_t meas_mode;
+    uint8_t error_id;
+    bool data_ready;
+    int64_t next_sample; /* uptime in ms, 0 if idle */
+    uint8_t alg_result[8];
+    uint8_t env_data[4];
+    uint8_t baseline[2];
+    uint8_t thresholds[5];
+    uint8_t range; /* eCO2 threshold range of the last result */
+    bool nint;     /* nINT asserted */
+    uint32_t seed;
+    struct k_timer timer; /* samples on time when nINT is wired */
+    struct k_spinlock lock;
+};
+
+/* Sample period of a drive mode, 0 if the mode does not measure */
+static uint32_t ccs811_emul_period_ms(const struct ccs811_emul_cfg *cfg,
+                                      uint8_t meas_mode)
+{
+    switch (CCS811_EMUL_DRIVE_MODE(meas_mode))
+    {
+    case 1:
+        return cfg->data_ready_ms;
+    case 2:
+        return cfg->data_ready_ms * 10;
+    case 3:
+        return cfg->data_ready_ms * 60;
+    case 4:
+        return cfg->data_ready_ms / 4;
+    default:
+        return 0;
+    }
+}
+
+/* eCO2 range 0 (low), 1 (medium) or 2 (high) with the hysteresis applied
+ * towards the range of the last result */
+static uint8_t ccs811_emul_range(struct ccs811_emul_data *data, uint16_t eco2)
+{
+    uint16_t low_to_med = sys_get_be16(&data->thresholds[0]);
+    uint16_t med_to_high = sys_get_be16(&data->thresholds[2]);
+    uint8_t hysteresis = data->thresholds[4];
+    uint8_t range = (eco2 > low_to_med) + (eco2 > med_to_high);
+
+    if (range > data->range &&
+        eco2 <= (range == 1 ? low_to_med : med_to_high) + hysteresis)
+    {
+        return data->range;
+    }
+    if (range < data->range &&
+        eco2 + hysteresis >= (data->range == 1 ? low_to_med : med_to_high))
+    {
+        return data->range;
+    }
+    return range;
+}
+
+static void ccs811_emul_sample(struct ccs811_emul_data *data)
+{
+    uint16_t eco2 = CLAMP(emul_waveform(700.0f, 250.0f, 3600, 20.0f, &data->seed),
+                          400.0f, 8192.0f);
+    uint16_t tvoc = CLAMP(emul_waveform(120.0f, 80.0f, 3600, 10.0f, &data->seed),
+                          0.0f, 1187.0f);
+    /* RAW_DATA: 6 bit heater current in uA, 10 bit ADC reading */
+    uint16_t adc = CLAMP(emul_waveform(500.0f, 100.0f, 3600, 20.0f, &data->seed),
+                         0.0f, 1023.0f);
+
+    sys_put_be16(eco2, &data->alg_result[0]);
+    sys_put_be16(tvoc, &data->alg_result[2]);
+    data->alg_result[5] = data->error_id;
+    sys_put_be16((12 << 10) | adc, &data->alg_result[6]);
+    data->data_ready = true;
+
+    /* nINT asserts on every result, or with thresholds only on a range
+     * change, and stays asserted until ALG_RESULT_DATA is read */
+    if (data->meas_mode & CCS811_EMUL_MEAS_MODE_INT_DATARDY)
+    {
+        uint8_t range = ccs811_emul_range(data, eco2);
+
+        if (!(data->meas_mode & CCS811_EMUL_MEAS_MODE_INT_THRESH) ||
+            range != data->range)
+        {
+            data->nint = true;
+        }
+        data->range = range;
+    }
+}
+
+/* nINT is active low */
+static void ccs811_emul_set_nint(const struct ccs811_emul_cfg *cfg,
+                                 struct ccs811_emul_data *data)
+{
+    if (cfg->irq.port != NULL)
+    {
+        gpio_emul_input_set(cfg->irq.port, cfg->irq.pin, data->nint ? 0 : 1);
+    }
+}
+
+static void ccs811_emul_update(const struct ccs811_emul_cfg *cfg,
+                               struct ccs811_emul_data *data)
+{
+    uint32_t period = ccs811_emul_period_ms(cfg, data->meas_mode);
+    int64_t now = k_uptime_get();
+
+    if (period == 0 || data->next_sample == 0 || now < data->next_sample)
+    {
+        return;
+    }
+    ccs811_emul_sample(data);
+    while (data->next_sample <= now)
+    {
+        data->next_sample += period;
+    }
+}
+
+static uint8_t ccs811_emul_status(struct ccs811_emul_data *data)
+{
+    uint8_t status = CCS811_EMUL_STATUS_APP_VALID;
+
+    if (data->app_mode)
+    {
+        status |= CCS811_EMUL_STATUS_FW_MODE;
+    }
+    if (data->data_ready)
+    {
+        status |= CCS811_EMUL_STATUS_DATA_READY;
+    }
+    if (data->error_id)
+    {
+        status |= CCS811_EMUL_STATUS_ERROR;
+    }
+    return status;
+}
+
+static int ccs811_emul_read(const struct ccs811_emul_cfg *cfg,
+                            struct ccs811_emul_data *data, uint8_t *buf,
+                            uint32_t len)
+{
+    const uint8_t *src = NULL;
+    uint8_t value[2] = {0};
+    uint32_t size = 1;
+
+    ccs811_emul_update(cfg, data);
+    memset(buf, 0, len);
+
+    switch (data->reg)
+    {
+    case CCS811_EMUL_REG_STATUS:
+        value[0] = ccs811_emul_status(data);
+        src = value;
+        break;
+    case CCS811_EMUL_REG_MEAS_MODE:
+        src = &data->meas_mode;
+        break;
+    case CCS811_EMUL_REG_ALG_RESULT_DATA:
+        data->alg_result[4] = ccs811_emul_status(data);
+        src = data->alg_result;
+        size = sizeof(data->alg_result);
+        data->data_ready = false;
+        data->nint = false;
+        break;
+    case CCS811_EMUL_REG_RAW_DATA:
+        src = &data->alg_result[6];
+        size = 2;
+        break;
+    case CCS811_EMUL_REG_BASELINE:
+        src = data->baseline;
+        size = sizeof(data->baseline);
+        break;
+    case CCS811_EMUL_REG_HW_ID:
+        value[0] = CCS811_EMUL_HW_ID;
+        src = value;
+        break;
+    case CCS811_EMUL_REG_HW_VERSION:
+        value[0] = 0x12;
+        src = value;
+        break;
+    case CCS811_EMUL_REG_FW_BOOT_VERSION:
+    case CCS811_EMUL_REG_FW_APP_VERSION:
+        value[0] = 0x20;
+        value[1] = 0x00;
+        src = value;
+        size = 2;
+        break;
+    case CCS811_EMUL_REG_ERROR_ID:
+        value[0] = data->error_id;
+        data->error_id = 0;
+        src = value;
+        break;
+    default:
+        data->error_id |= CCS811_EMUL_ERROR_READ_REG_INVALID;
+        return 0;
+    }
+
+    memcpy(buf, src, MIN(len, size));
+    return 0;
+}
+
+static int ccs811_emul_write(const struct ccs811_emul_cfg *cfg,
+                             struct ccs811_emul_data *data, const uint8_t *buf,
+                             uint32_t len)
+{
+    if (len == 0)
+    {
+        return -EIO;
+    }
+
+    data->reg = buf[0];
+    buf++;
+    len--;
+
+    switch (data->reg)
+    {
+    case CCS811_EMUL_REG_APP_START:
+        data->app_mode = true;
+        break;
+    case CCS811_EMUL_REG_SW_RESET:
+        if (len == sizeof(ccs811_emul_reset_seq) &&
+            memcmp(buf, ccs811_emul_reset_seq, len) == 0)
+        {
+            data->app_mode = false;
+            data->meas_mode = 0;
+            data->next_sample = 0;
+            data->data_ready = false;
+            data->error_id = 0;
+            data->nint = false;
+            k_timer_stop(&data->timer);
+        }
+        break;
+    case CCS811_EMUL_REG_MEAS_MODE:
+        if (len == 0)
+        {
+            break;
+        }
+        if (!data->app_mode || CCS811_EMUL_DRIVE_MODE(buf[0]) > 4)
+        {
+            data->error_id |= CCS811_EMUL_ERROR_MEASMODE_INVALID;
+            break;
+        }
+        data->meas_mode = buf[0];
+        data->next_sample = k_uptime_get() + ccs811_emul_period_ms(cfg, buf[0]);
+        data->data_ready = false;
+        data->nint = false;
+        if (cfg->irq.port != NULL && ccs811_emul_period_ms(cfg, buf[0]) != 0)
+        {
+            k_timer_start(&data->timer, K_MSEC(ccs811_emul_period_ms(cfg, buf[0])),
+                          K_MSEC(ccs811_emul_period_ms(cfg, buf[0])));
+        }
+        else
+        {
+            k_timer_stop(&data->timer);
+        }
+        break;
+    case CCS811_EMUL_REG_ENV_DATA:
+        memcpy(data->env_data, buf, MIN(len, sizeof(data->env_data)));
+        break;
+    case CCS811_EMUL_REG_BASELINE:
+        memcpy(data->baseline, buf, MIN(len, sizeof(data->baseline)));
+        break;
+    case CCS811_EMUL_REG_THRESHOLDS:
+        memcpy(data->thresholds, buf, MIN(len, sizeof(data->thresholds)));
+        break;
+    default:
+        if (len > 0)
+        {
+            data->error_id |= CCS811_EMUL_ERROR_WRITE_REG_INVALID;
+        }
+        break;
+    }
+    return 0;
+}
+
+static int ccs811_emul_transfer(const struct emul *target, struct i2c_msg *msgs,
+                                int num_msgs, int addr)
+{
+    const struct ccs811_emul_cfg *cfg = target->cfg;
+    struct ccs811_emul_data *data = target->data;
+    k_spinlock_key_t key;
+    int ret = 0;
+
+    ARG_UNUSED(addr);
+
+    key = k_spin_lock(&data->lock);
+    for (int i = 0; i < num_msgs && ret == 0; i++)
+    {
+        if (msgs[i].flags & I2C_MSG_READ)
+        {
+            ret = ccs811_emul_read(cfg, data, msgs[i].buf, msgs[i].len);
+        }
+        else
+        {
+            ret = ccs811_emul_write(cfg, data, msgs[i].buf, msgs[i].len);
+        }
+    }
+    ccs811_emul_set_nint(cfg, data);
+    k_spin_unlock(&data->lock, key);
+    return ret;
+}
+
+static void ccs811_emul_timer(struct k_timer *timer)
+{
+    const struct emul *target = k_timer_user_data_get(timer);
+    struct ccs811_emul_data *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    ccs811_emul_update(target->cfg, data);
+    ccs811_emul_set_nint(target->cfg, data);
+    k_spin_unlock(&data->lock, key);
+}
+
+static const struct i2c_emul_api ccs811_emul_api = {
+    .transfer = ccs811_emul_transfer,
+};
+
+static int ccs811_emul_init(const struct emul *target, const struct device *parent)
+{
+    struct ccs811_emul_data *data = target->data;
+
+    ARG_UNUSED(parent);
+
+    data->seed = 811;
+    /* power-on defaults of the THRESHOLDS register */
+    sys_put_be16(1500, &data->thresholds[0]);
+    sys_put_be16(2500, &data->thresholds[2]);
+    data->thresholds[4] = 50;
+    k_timer_init(&data->timer, ccs811_emul_timer, NULL);
+    k_timer_user_data_set(&data->timer, (void *)target);
+    ccs811_emul_set_nint(target->cfg, data);
+    return 0;
+}
+
+#define CCS811_EMUL(n)                                                    \
+    static struct ccs811_emul_data ccs811_emul_data_##n;                  \
+    static const struct ccs811_emul_cfg ccs811_emul_cfg_##n = {           \
+        .data_ready_ms = DT_INST_PROP(n, data_ready_ms),                  \
+        .irq = GPIO_DT_SPEC_INST_GET_OR(n, irq_gpios, {0}),               \
+    };                                                                    \
+    EMUL_DT_INST_DEFINE(n, ccs811_emul_init, &ccs811_emul_data_##n,       \
+                        &ccs811_emul_cfg_##n, &ccs811_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(CCS811_EMUL)
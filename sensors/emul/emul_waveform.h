@@ -0,0 +1,26 @@
+#ifndef EMUL_WAVEFORM_H
+#define EMUL_WAVEFORM_H
+
+#include <math.h>
+#include <zephyr/kernel.h>
+
+/**
+ * Slowly varying test signal for the sensor models: a sine of the given
+ * period around base, plus deterministic noise of up to +-noise so repeated
+ * runs produce the same samples.
+ *
+ * @param seed Noise generator state, owned by the caller
+ */
+static inline float emul_waveform(float base, float amplitude,
+                                  uint32_t period_s, float noise,
+                                  uint32_t *seed)
+{
+    float phase = (float)(k_uptime_get() % (period_s * 1000LL)) /
+                  (period_s * 1000.0f);
+
+    *seed = *seed * 1103515245U + 12345U;
+    return base + amplitude * sinf(2.0f * 3.14159265f * phase) +
+           noise * ((float)(*seed >> 16 & 0x7FFF) / 16383.5f - 1.0f);
+}
+
+#endif
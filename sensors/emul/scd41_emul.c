@@ -0,0 +1,244 @@
+#define DT_DRV_COMPAT sensirion_scd41_emul
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include "sensirion_emul.h"
+#include "emul_waveform.h"
+
+/* Delay of a temperature and humidity only single shot */
+#define SCD41_EMUL_RHT_ONLY_MS 50
+#define SCD41_EMUL_LOW_POWER_FACTOR 6
+#define SCD41_EMUL_DEFAULT_TEMP_OFFSET 1498 /* 4 degC in ticks */
+#define SCD41_EMUL_DEFAULT_PRESSURE 1013    /* hPa */
+
+struct scd41_emul_cfg
+{
+    uint32_t data_ready_ms;
+    uint32_t crc_error_interval;
+};
+
+struct scd41_emul_data
+{
+    struct sensirion_emul_state state; /* must be first */
+    bool asleep;
+    bool periodic;
+    uint32_t interval_ms;
+    int64_t next_sample; /* uptime in ms, 0 if no measurement is running */
+    bool data_ready;
+    uint16_t co2;
+    uint16_t temperature;
+    uint16_t humidity;
+    uint16_t temp_offset;
+    uint16_t altitude;
+    uint16_t pressure;
+    uint16_t asc_enabled;
+    uint32_t seed;
+};
+
+static void scd41_emul_defaults(struct scd41_emul_data *data)
+{
+    data->periodic = false;
+    data->next_sample = 0;
+    data->data_ready = false;
+    data->temp_offset = SCD41_EMUL_DEFAULT_TEMP_OFFSET;
+    data->altitude = 0;
+    data->pressure = SCD41_EMUL_DEFAULT_PRESSURE;
+    data->asc_enabled = 1;
+}
+
+static void scd41_emul_sample(struct scd41_emul_data *data)
+{
+    float co2 = emul_waveform(800.0f, 300.0f, 3600, 15.0f, &data->seed);
+    float temperature = emul_waveform(22.5f, 2.0f, 3600, 0.1f, &data->seed);
+    float humidity = emul_waveform(45.0f, 10.0f, 3600, 0.5f, &data->seed);
+
+    data->co2 = CLAMP(co2, 400.0f, 5000.0f);
+    data->temperature = (temperature + 45.0f) * 65535.0f / 175.0f;
+    data->humidity = CLAMP(humidity, 0.0f, 100.0f) * 65535.0f / 100.0f;
+    data->data_ready = true;
+}
+
+static void scd41_emul_update(struct scd41_emul_data *data)
+{
+    int64_t now = k_uptime_get();
+
+    if (data->next_sample == 0 || now < data->next_sample)
+    {
+        return;
+    }
+
+    scd41_emul_sample(data);
+    if (data->periodic)
+    {
+        while (data->next_sample <= now)
+        {
+            data->next_sample += data->interval_ms;
+        }
+    }
+    else
+    {
+        data->next_sample = 0;
+    }
+}
+
+static void scd41_emul_start(struct scd41_emul_data *data, bool periodic,
+                             uint32_t delay_ms)
+{
+    data->periodic = periodic;
+    data->interval_ms = delay_ms;
+    data->next_sample = k_uptime_get() + delay_ms;
+    data->data_ready = false;
+}
+
+static int scd41_emul_cmd(const struct emul *target,
+                          struct sensirion_emul_state *state)
+{
+    const struct scd41_emul_cfg *cfg = target->cfg;
+    struct scd41_emul_data *data = target->data;
+    uint16_t words[3];
+
+    if (state->cmd == 0x36F6)
+    {
+        /* wake_up: the sensor wakes but does not acknowledge */
+        data->asleep = false;
+        return -EIO;
+    }
+    if (data->asleep)
+    {
+        return -EIO;
+    }
+
+    scd41_emul_update(data);
+
+    switch (state->cmd)
+    {
+    case 0x21B1: /* start_periodic_measurement */
+        scd41_emul_start(data, true, cfg->data_ready_ms);
+        break;
+    case 0x21AC: /* start_low_power_periodic_measurement */
+        scd41_emul_start(data, true,
+                         cfg->data_ready_ms * SCD41_EMUL_LOW_POWER_FACTOR);
+        break;
+    case 0x219D: /* measure_single_shot */
+        scd41_emul_start(data, false, cfg->data_ready_ms);
+        break;
+    case 0x2196: /* measure_single_shot_rht_only */
+        scd41_emul_start(data, false, SCD41_EMUL_RHT_ONLY_MS);
+        break;
+    case 0x3F86: /* stop_periodic_measurement */
+        data->periodic = false;
+        data->next_sample = 0;
+        data->data_ready = false;
+        break;
+    case 0xEC05: /* read_measurement */
+        if (!data->data_ready)
+        {
+            return -EIO;
+        }
+        words[0] = data->co2;
+        words[1] = data->temperature;
+        words[2] = data->humidity;
+        data->data_ready = false;
+        sensirion_emul_respond(state, words, 3);
+        break;
+    case 0xE4B8: /* get_data_ready_flag */
+        words[0] = data->data_ready ? 0x8006 : 0x8000;
+        sensirion_emul_respond(state, words, 1);
+        break;
+    case 0x241D: /* set_temperature_offset */
+        data->temp_offset = state->num_args ? state->args[0] : 0;
+        break;
+    case 0x2318: /* get_temperature_offset */
+        sensirion_emul_respond(state, &data->temp_offset, 1);
+        break;
+    case 0x2427: /* set_sensor_altitude */
+        data->altitude = state->num_args ? state->args[0] : 0;
+        break;
+    case 0x2322: /* get_sensor_altitude */
+        sensirion_emul_respond(state, &data->altitude, 1);
+        break;
+    case 0xE000: /* set/get_ambient_pressure */
+        if (state->num_args)
+        {
+            data->pressure = state->args[0];
+        }
+        else
+        {
+            sensirion_emul_respond(state, &data->pressure, 1);
+        }
+        break;
+    case 0x2416: /* set_automatic_self_calibration */
+        data->asc_enabled = state->num_args ? state->args[0] : 0;
+        break;
+    case 0x2313: /* get_automatic_self_calibration */
+        sensirion_emul_respond(state, &data->asc_enabled, 1);
+        break;
+    case 0x362F: /* perform_forced_recalibration */
+        words[0] = 0x8000; /* no correction */
+        sensirion_emul_respond(state, words, 1);
+        break;
+    case 0x3682: /* get_serial_number */
+        words[0] = 0xBEEF;
+        words[1] = 0xCAFE;
+        words[2] = 0x0041;
+        sensirion_emul_respond(state, words, 3);
+        break;
+    case 0x3639: /* perform_self_test */
+        words[0] = 0;
+        sensirion_emul_respond(state, words, 1);
+        break;
+    case 0x3632: /* perform_factory_reset */
+        scd41_emul_defaults(data);
+        break;
+    case 0x36E0: /* power_down */
+        data->asleep = true;
+        data->periodic = false;
+        data->next_sample = 0;
+        break;
+    case 0x3615: /* persist_settings */
+    case 0x3646: /* reinit */
+        break;
+    default:
+        return -EIO;
+    }
+    return 0;
+}
+
+static int scd41_emul_transfer(const struct emul *target, struct i2c_msg *msgs,
+                               int num_msgs, int addr)
+{
+    ARG_UNUSED(addr);
+
+    return sensirion_emul_transfer(target, msgs, num_msgs, scd41_emul_cmd);
+}
+
+static const struct i2c_emul_api scd41_emul_api = {
+    .transfer = scd41_emul_transfer,
+};
+
+static int scd41_emul_init(const struct emul *target, const struct device *parent)
+{
+    const struct scd41_emul_cfg *cfg = target->cfg;
+    struct scd41_emul_data *data = target->data;
+
+    ARG_UNUSED(parent);
+
+    data->state.crc_error_every = cfg->crc_error_interval;
+    data->seed = 41;
+    scd41_emul_defaults(data);
+    return 0;
+}
+
+#define SCD41_EMUL(n)                                                     \
+    static struct scd41_emul_data scd41_emul_data_##n;                    \
+    static const struct scd41_emul_cfg scd41_emul_cfg_##n = {             \
+        .data_ready_ms = DT_INST_PROP(n, data_ready_ms),                  \
+        .crc_error_interval = DT_INST_PROP(n, crc_error_interval),        \
+    };                                                                    \
+    EMUL_DT_INST_DEFINE(n, scd41_emul_init, &scd41_emul_data_##n,         \
+                        &scd41_emul_cfg_##n, &scd41_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(SCD41_EMUL)
@@ -0,0 +1,132 @@
+#include "sensirion_emul.h"
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/byteorder.h>
+#include <stdlib.h>
+#include "../scd41/sensirion_i2c.h"
+
+static inline struct sensirion_emul_state *emul_state(const struct emul *target)
+{
+    return target->data;
+}
+
+static int sensirion_emul_write(const struct emul *target,
+                                struct sensirion_emul_state *state,
+                                const struct i2c_msg *msg,
+                                sensirion_emul_cmd_fn handle_cmd)
+{
+    if (msg->len < 2 || (msg->len - 2) % 3 != 0 ||
+        (msg->len - 2) / 3 > ARRAY_SIZE(state->args))
+    {
+        return -EIO;
+    }
+
+    state->cmd = sys_get_be16(msg->buf);
+    state->num_args = 0;
+    for (uint32_t i = 2; i < msg->len; i += 3)
+    {
+        if (sensirion_i2c_generate_crc(&msg->buf[i], 2) != msg->buf[i + 2])
+        {
+            /* the sensors ignore commands with a corrupted argument */
+            return -EIO;
+        }
+        state->args[state->num_args++] = sys_get_be16(&msg->buf[i]);
+    }
+
+    state->response_words = 0;
+    return handle_cmd(target, state);
+}
+
+static int sensirion_emul_read(struct sensirion_emul_state *state,
+                               struct i2c_msg *msg)
+{
+    bool corrupt;
+
+    /* partial reads of a response are fine, reading past its end is not */
+    if (state->response_words == 0 || msg->len % 3 != 0 ||
+        msg->len / 3 > state->response_words)
+    {
+        return -EIO;
+    }
+
+    state->responses++;
+    corrupt = state->crc_errors_pending > 0 ||
+              (state->crc_error_every &&
+               state->responses % state->crc_error_every == 0);
+    if (state->crc_errors_pending > 0)
+    {
+        state->crc_errors_pending--;
+    }
+
+    for (uint32_t i = 0; i < msg->len / 3; i++)
+    {
+        uint8_t *word = &msg->buf[i * 3];
+
+        sys_put_be16(state->response[i], word);
+        word[2] = sensirion_i2c_generate_crc(word, 2);
+    }
+    if (corrupt)
+    {
+        msg->buf[msg->len - 1] ^= 0xA5;
+    }
+
+    state->response_words = 0;
+    return 0;
+}
+
+int sensirion_emul_transfer(const struct emul *target, struct i2c_msg *msgs,
+                            int num_msgs, sensirion_emul_cmd_fn handle_cmd)
+{
+    struct sensirion_emul_state *state = emul_state(target);
+    int ret = 0;
+
+    for (int i = 0; i < num_msgs && ret == 0; i++)
+    {
+        if (msgs[i].flags & I2C_MSG_READ)
+        {
+            ret = sensirion_emul_read(state, &msgs[i]);
+        }
+        else
+        {
+            ret = sensirion_emul_write(target, state, &msgs[i], handle_cmd);
+        }
+    }
+    return ret;
+}
+
+void sensirion_emul_respond(struct sensirion_emul_state *state,
+                            const uint16_t *words, uint8_t num_words)
+{
+    num_words = MIN(num_words, SENSIRION_EMUL_MAX_WORDS);
+    memcpy(state->response, words, num_words * sizeof(words[0]));
+    state->response_words = num_words;
+}
+
+void sensirion_emul_inject_crc_errors(const struct emul *target,
+                                      uint16_t count)
+{
+    emul_state(target)->crc_errors_pending = count;
+}
+
+static int cmd_emul_crc(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct emul *target = emul_get_binding(argv[1]);
+
+    if (target == NULL)
+    {
+        shell_error(sh, "No emulator %s", argv[1]);
+        return -ENODEV;
+    }
+    sensirion_emul_inject_crc_errors(target, strtoul(argv[2], NULL, 0));
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_sensirion_emul,
+    SHELL_CMD_ARG(crc, NULL, "<emulator> <count>: corrupt the next responses",
+                  cmd_emul_crc, 3, 0),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(sensirion_emul, &sub_sensirion_emul,
+                   "Emulated Sensirion sensors", NULL);
@@ -0,0 +1,64 @@
+#ifndef SENSIRION_EMUL_H
+#define SENSIRION_EMUL_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+
+/* Longest response of an emulated Sensirion sensor (SPS30 serial number). */
+#define SENSIRION_EMUL_MAX_WORDS 24
+
+/**
+ * Protocol state shared by the Sensirion sensor models: the last command
+ * word, the response armed by it and the CRC error injection. It must be the
+ * first member of each model's data so the common code can find it.
+ */
+struct sensirion_emul_state
+{
+    uint16_t cmd;
+    uint16_t args[4];
+    uint8_t num_args;
+    uint16_t response[SENSIRION_EMUL_MAX_WORDS];
+    uint8_t response_words;
+    uint32_t responses;       /* responses sent, used for periodic CRC errors */
+    uint32_t crc_error_every; /* 0: never */
+    uint16_t crc_errors_pending;
+};
+
+/**
+ * Handles the sensor specific part of a command once its command word and
+ * arguments were written. Arms a response with sensirion_emul_respond().
+ *
+ * @returns 0 to acknowledge the command, -EIO to NACK it
+ */
+typedef int (*sensirion_emul_cmd_fn)(const struct emul *target,
+                                     struct sensirion_emul_state *state);
+
+/**
+ * Run one I2C transfer against a Sensirion sensor model. Writes are decoded
+ * into a command word and CRC-checked argument words, reads return the armed
+ * response with CRCs. Reading without an armed response is NACKed, as the real
+ * sensors do.
+ */
+int sensirion_emul_transfer(const struct emul *target, struct i2c_msg *msgs,
+                            int num_msgs, sensirion_emul_cmd_fn handle_cmd);
+
+/**
+ * Arm the response to the current command.
+ */
+void sensirion_emul_respond(struct sensirion_emul_state *state,
+                            const uint16_t *words, uint8_t num_words);
+
+/**
+ * Corrupt the CRC of the next count responses of an emulated sensor.
+ */
+void sensirion_emul_inject_crc_errors(const struct emul *target,
+                                      uint16_t count);
+
+/**
+ * Set the device status register an emulated SPS30 reports, e.g. a fan
+ * speed warning. The flags stay until they are set again.
+ */
+void sps30_emul_set_status(const struct emul *target, uint32_t status);
+
+#endif
@@ -0,0 +1,257 @@
+#define DT_DRV_COMPAT sensirion_sps30_emul
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include "sensirion_emul.h"
+#include "emul_waveform.h"
+
+#define SPS30_EMUL_FORMAT_FLOAT 0x0300
+#define SPS30_EMUL_FORMAT_UINT16 0x0500
+#define SPS30_EMUL_NUM_VALUES 10
+#define SPS30_EMUL_DEFAULT_AUTOCLEAN (7 * 24 * 60 * 60) /* seconds */
+#define SPS30_EMUL_FIRMWARE_VERSION 0x0202
+#define SPS30_EMUL_SERIAL "EMUL30000000000"
+#define SPS30_EMUL_SERIAL_WORDS 16
+
+struct sps30_emul_cfg
+{
+    uint32_t data_ready_ms;
+    uint32_t crc_error_interval;
+};
+
+struct sps30_emul_data
+{
+    struct sensirion_emul_state state; /* must be first */
+    bool asleep;
+    bool interface_awake; /* first access after sleep only wakes the bus */
+    bool measuring;
+    uint16_t format;
+    int64_t next_sample; /* uptime in ms */
+    bool data_ready;
+    float values[SPS30_EMUL_NUM_VALUES];
+    uint32_t autoclean_interval;
+    uint32_t status; /* device status register */
+    uint32_t seed;
+};
+
+static void sps30_emul_sample(struct sps30_emul_data *data)
+{
+    float pm1 = MAX(emul_waveform(6.0f, 4.0f, 1800, 0.8f, &data->seed), 0.3f);
+    float pm2p5 = pm1 * 1.4f;
+    float pm4 = pm2p5 * 1.1f;
+    float pm10 = pm4 * 1.1f;
+
+    /* same order as the sensor: mass, number concentrations, typical size */
+    data->values[0] = pm1;
+    data->values[1] = pm2p5;
+    data->values[2] = pm4;
+    data->values[3] = pm10;
+    data->values[4] = pm1 * 6.5f;
+    data->values[5] = pm1 * 7.5f;
+    data->values[6] = pm2p5 * 5.5f;
+    data->values[7] = pm4 * 5.1f;
+    data->values[8] = pm10 * 4.7f;
+    data->values[9] = emul_waveform(0.6f, 0.1f, 1800, 0.05f, &data->seed);
+    data->data_ready = true;
+}
+
+static void sps30_emul_update(const struct sps30_emul_cfg *cfg,
+                              struct sps30_emul_data *data)
+{
+    int64_t now = k_uptime_get();
+
+    if (!data->measuring || now < data->next_sample)
+    {
+        return;
+    }
+    sps30_emul_sample(data);
+    while (data->next_sample <= now)
+    {
+        data->next_sample += cfg->data_ready_ms;
+    }
+}
+
+static void sps30_emul_respond_measurement(struct sps30_emul_data *data)
+{
+    uint16_t words[SPS30_EMUL_NUM_VALUES * 2];
+    uint8_t num_words = 0;
+
+    for (int i = 0; i < SPS30_EMUL_NUM_VALUES; i++)
+    {
+        if (data->format == SPS30_EMUL_FORMAT_UINT16)
+        {
+            /* typical particle size is reported in nm */
+            float scale = i == SPS30_EMUL_NUM_VALUES - 1 ? 1000.0f : 1.0f;
+
+            words[num_words++] = CLAMP(data->values[i] * scale, 0.0f, 65535.0f);
+        }
+        else
+        {
+            uint32_t raw;
+
+            memcpy(&raw, &data->values[i], sizeof(raw));
+            words[num_words++] = raw >> 16;
+            words[num_words++] = raw & 0xFFFF;
+        }
+    }
+    sensirion_emul_respond(&data->state, words, num_words);
+}
+
+static int sps30_emul_cmd(const struct emul *target,
+                          struct sensirion_emul_state *state)
+{
+    const struct sps30_emul_cfg *cfg = target->cfg;
+    struct sps30_emul_data *data = target->data;
+    uint16_t words[SPS30_EMUL_SERIAL_WORDS];
+
+    if (data->asleep)
+    {
+        if (!data->interface_awake)
+        {
+            data->interface_awake = true;
+            return -EIO;
+        }
+        if (state->cmd != 0x1103)
+        {
+            return -EIO;
+        }
+        data->asleep = false;
+        return 0;
+    }
+
+    sps30_emul_update(cfg, data);
+
+    switch (state->cmd)
+    {
+    case 0x0010: /* start_measurement */
+        if (state->num_args != 1 ||
+            (state->args[0] != SPS30_EMUL_FORMAT_FLOAT &&
+             state->args[0] != SPS30_EMUL_FORMAT_UINT16))
+        {
+            return -EIO;
+        }
+        data->format = state->args[0];
+        data->measuring = true;
+        data->data_ready = false;
+        memset(data->values, 0, sizeof(data->values));
+        data->next_sample = k_uptime_get() + cfg->data_ready_ms;
+        break;
+    case 0x0104: /* stop_measurement */
+        data->measuring = false;
+        data->data_ready = false;
+        break;
+    case 0x0202: /* read_data_ready */
+        words[0] = data->data_ready;
+        sensirion_emul_respond(state, words, 1);
+        break;
+    case 0x0300: /* read_measurement, repeats the last values if none new */
+        if (!data->measuring)
+        {
+            return -EIO;
+        }
+        sps30_emul_respond_measurement(data);
+        data->data_ready = false;
+        break;
+    case 0x1001: /* sleep */
+        if (data->measuring)
+        {
+            return -EIO;
+        }
+        data->asleep = true;
+        data->interface_awake = false;
+        break;
+    case 0x1103: /* wake_up */
+        break;
+    case 0x5607: /* start_fan_cleaning */
+        if (!data->measuring)
+        {
+            return -EIO;
+        }
+        break;
+    case 0x8004: /* read/write auto cleaning interval */
+        if (state->num_args == 2)
+        {
+            data->autoclean_interval =
+                ((uint32_t)state->args[0] << 16) | state->args[1];
+        }
+        else
+        {
+            words[0] = data->autoclean_interval >> 16;
+            words[1] = data->autoclean_interval & 0xFFFF;
+            sensirion_emul_respond(state, words, 2);
+        }
+        break;
+    case 0xD100: /* read_firmware_version */
+        words[0] = SPS30_EMUL_FIRMWARE_VERSION;
+        sensirion_emul_respond(state, words, 1);
+        break;
+    case 0xD033: /* read_serial_number */
+        memset(words, 0, sizeof(words));
+        for (int i = 0; i < sizeof(SPS30_EMUL_SERIAL) - 1; i++)
+        {
+            words[i / 2] |= (uint16_t)SPS30_EMUL_SERIAL[i] << (i % 2 ? 0 : 8);
+        }
+        sensirion_emul_respond(state, words, SPS30_EMUL_SERIAL_WORDS);
+        break;
+    case 0xD206: /* read_device_status_register */
+        words[0] = data->status >> 16;
+        words[1] = data->status & 0xFFFF;
+        sensirion_emul_respond(state, words, 2);
+        break;
+    case 0xD304: /* device_reset */
+        data->measuring = false;
+        data->data_ready = false;
+        break;
+    default:
+        return -EIO;
+    }
+    return 0;
+}
+
+static int sps30_emul_transfer(const struct emul *target, struct i2c_msg *msgs,
+                               int num_msgs, int addr)
+{
+    ARG_UNUSED(addr);
+
+    return sensirion_emul_transfer(target, msgs, num_msgs, sps30_emul_cmd);
+}
+
+void sps30_emul_set_status(const struct emul *target, uint32_t status)
+{
+    struct sps30_emul_data *data = target->data;
+
+    data->status = status;
+}
+
+static const struct i2c_emul_api sps30_emul_api = {
+    .transfer = sps30_emul_transfer,
+};
+
+static int sps30_emul_init(const struct emul *target, const struct device *parent)
+{
+    const struct sps30_emul_cfg *cfg = target->cfg;
+    struct sps30_emul_data *data = target->data;
+
+    ARG_UNUSED(parent);
+
+    data->state.crc_error_every = cfg->crc_error_interval;
+    data->autoclean_interval = SPS30_EMUL_DEFAULT_AUTOCLEAN;
+    data->format = SPS30_EMUL_FORMAT_FLOAT;
+    data->seed = 30;
+    return 0;
+}
+
+#define SPS30_EMUL(n)                                                     \
+    static struct sps30_emul_data sps30_emul_data_##n;                    \
+    static const struct sps30_emul_cfg sps30_emul_cfg_##n = {             \
+        .data_ready_ms = DT_INST_PROP(n, data_ready_ms),                  \
+        .crc_error_interval = DT_INST_PROP(n, crc_error_interval),        \
+    };                                                                    \
+    EMUL_DT_INST_DEFINE(n, sps30_emul_init, &sps30_emul_data_##n,         \
+                        &sps30_emul_cfg_##n, &sps30_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(SPS30_EMUL)
@@ -0,0 +1,105 @@
+#include "i2c_bus.h"
+#include "i2c_engine.h"
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+#define I2C_BUS_NODE(n) DT_NODELABEL(i2c##n)
+#define I2C_BUS_DEV(n)                                          \
+    COND_CODE_1(DT_NODE_HAS_STATUS(I2C_BUS_NODE(n), okay),      \
+                (DEVICE_DT_GET(I2C_BUS_NODE(n))), (NULL))
+#define I2C_BUS_ENTRY(n, _) {.dev = I2C_BUS_DEV(n), .idx = n}
+#define I2C_BUS_OKAY(n, _)                                      \
+    COND_CODE_1(DT_NODE_HAS_STATUS(I2C_BUS_NODE(n), okay), (1), (0))
+/* Buses enabled in the devicetree; only these get an engine stack. */
+#define I2C_BUS_COUNT (LISTIFY(I2C_BUS_MAX, I2C_BUS_OKAY, (+), _))
+
+static struct i2c_bus i2c_buses[I2C_BUS_MAX] = {
+    LISTIFY(I2C_BUS_MAX, I2C_BUS_ENTRY, (, ), _)};
+
+static K_THREAD_STACK_ARRAY_DEFINE(i2c_bus_stacks, I2C_BUS_COUNT,
+                                   I2C_ENGINE_STACK_SIZE);
+
+static uint8_t selected_bus_idx;
+
+struct i2c_bus *i2c_bus_get(uint8_t bus_idx)
+{
+    if (bus_idx >= I2C_BUS_MAX || i2c_buses[bus_idx].tid == NULL)
+    {
+        return NULL;
+    }
+    return &i2c_buses[bus_idx];
+}
+
+struct i2c_bus *i2c_bus_find(const struct device *dev)
+{
+    for (uint8_t i = 0; i < I2C_BUS_MAX; i++)
+    {
+        if (dev != NULL && i2c_buses[i].dev == dev)
+        {
+            return i2c_bus_get(i);
+        }
+    }
+    return NULL;
+}
+
+int i2c_bus_select(uint8_t bus_idx)
+{
+    if (i2c_bus_get(bus_idx) == NULL)
+    {
+        return -ENODEV;
+    }
+    selected_bus_idx = bus_idx;
+    return 0;
+}
+
+struct i2c_bus *i2c_bus_selected(void)
+{
+    return i2c_bus_get(selected_bus_idx);
+}
+
+int i2c_bus_lock(struct i2c_bus *bus, k_timeout_t timeout)
+{
+    return k_mutex_lock(&bus->lock, timeout);
+}
+
+void i2c_bus_unlock(struct i2c_bus *bus)
+{
+    k_mutex_unlock(&bus->lock);
+}
+
+static int i2c_bus_init(void)
+{
+    bool have_default = false;
+    uint8_t stack = 0;
+
+    for (uint8_t i = 0; i < I2C_BUS_MAX; i++)
+    {
+        struct i2c_bus *bus = &i2c_buses[i];
+
+        if (bus->dev == NULL)
+        {
+            continue;
+        }
+        if (!device_is_ready(bus->dev))
+        {
+            printk("I2C bus %u not ready\n", i);
+            continue;
+        }
+
+        k_mutex_init(&bus->lock);
+        i2c_engine_start(bus, i2c_bus_stacks[stack],
+                         K_THREAD_STACK_SIZEOF(i2c_bus_stacks[stack]));
+        stack++;
+        if (!have_default)
+        {
+            selected_bus_idx = i;
+            have_default = true;
+        }
+    }
+    return 0;
+}
+
+SYS_INIT(i2c_bus_init, POST_KERNEL, CONFIG_APPLICATION_INIT_PRIORITY);
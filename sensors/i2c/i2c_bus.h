@@ -0,0 +1,63 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+
+/* Highest controller index probed from devicetree (labels i2c0..i2c3). */
+#define I2C_BUS_MAX 4
+
+/**
+ * One I2C controller. Every transfer on the bus is executed by the bus's own
+ * engine thread while holding lock, so buses run in parallel while access to
+ * each one stays serialized.
+ */
+struct i2c_bus
+{
+    const struct device *dev;
+    uint8_t idx;
+    struct k_mutex lock;
+    struct k_fifo queue;
+    struct k_thread thread;
+    k_tid_t tid;
+};
+
+/**
+ * Get a bus by its devicetree index (i2c0 -> 0, i2c1 -> 1, ...).
+ *
+ * @returns the bus, or NULL if the controller is absent or not ready
+ */
+struct i2c_bus *i2c_bus_get(uint8_t bus_idx);
+
+/**
+ * Get the bus that wraps a controller device.
+ *
+ * @returns the bus, or NULL if the device is not a managed controller
+ */
+struct i2c_bus *i2c_bus_find(const struct device *dev);
+
+/**
+ * Select the bus for drivers whose HAL only passes an address (the Sensirion
+ * drivers). Their following transfers go to this bus, so devices with the
+ * same address on different buses are told apart by selecting the bus
+ * first. Those drivers are used from one thread at a time. The first ready
+ * bus is selected at boot.
+ *
+ * @returns 0 on success, -ENODEV for an unknown bus
+ */
+int i2c_bus_select(uint8_t bus_idx);
+
+/**
+ * @returns the bus selected with i2c_bus_select(), or NULL if there is none
+ */
+struct i2c_bus *i2c_bus_selected(void);
+
+/**
+ * Take exclusive ownership of a bus. While held, queued transfers on the bus
+ * wait; the owner must not submit through the engine itself.
+ */
+int i2c_bus_lock(struct i2c_bus *bus, k_timeout_t timeout);
+
+void i2c_bus_unlock(struct i2c_bus *bus);
+
+#endif
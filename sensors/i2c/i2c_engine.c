@@ -0,0 +1,149 @@
+#include "i2c_engine.h"
+#include "i2c_bus.h"
+#include "i2c_stats.h"
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/i2c.h>
+
+static int i2c_engine_execute(struct i2c_bus *bus, uint16_t addr,
+                              struct i2c_msg *msgs, uint8_t num_msgs)
+{
+    uint32_t start;
+    uint32_t bytes = 0;
+    int ret;
+
+    for (uint8_t i = 0; i < num_msgs; i++)
+    {
+        bytes += msgs[i].len;
+    }
+
+    k_mutex_lock(&bus->lock, K_FOREVER);
+    start = k_cycle_get_32();
+    ret = i2c_transfer(bus->dev, msgs, num_msgs, addr);
+    i2c_stats_record_transfer(bus->idx, addr, bytes,
+                              k_cyc_to_us_floor32(k_cycle_get_32() - start), ret);
+    k_mutex_unlock(&bus->lock);
+    return ret;
+}
+
+static void i2c_engine_thread(void *p1, void *p2, void *p3)
+{
+    struct i2c_bus *bus = p1;
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (1)
+    {
+        struct i2c_txn *txn = k_fifo_get(&bus->queue, K_FOREVER);
+
+        txn->result = i2c_engine_execute(bus, txn->addr, txn->msgs, txn->num_msgs);
+        txn->cb(txn, txn->result);
+    }
+}
+
+void i2c_engine_start(struct i2c_bus *bus, k_thread_stack_t *stack,
+                      size_t stack_size)
+{
+    char name[] = "i2c_engine0";
+
+    k_fifo_init(&bus->queue);
+    bus->tid = k_thread_create(&bus->thread, stack, stack_size,
+                               i2c_engine_thread, bus, NULL, NULL,
+                               I2C_ENGINE_PRIORITY, 0, K_NO_WAIT);
+    name[sizeof(name) - 2] = '0' + bus->idx;
+    k_thread_name_set(bus->tid, name);
+}
+
+int i2c_engine_submit(struct i2c_txn *txn)
+{
+    if (txn->bus == NULL || txn->msgs == NULL || txn->num_msgs == 0 || txn->cb == NULL)
+    {
+        return -EINVAL;
+    }
+
+    k_fifo_put(&txn->bus->queue, txn);
+    return 0;
+}
+
+static void i2c_engine_sync_cb(struct i2c_txn *txn, int result)
+{
+    ARG_UNUSED(result);
+    k_sem_give((struct k_sem *)txn->user_data);
+}
+
+int i2c_engine_transfer(struct i2c_bus *bus, uint16_t addr,
+                        struct i2c_msg *msgs, uint8_t num_msgs)
+{
+    struct k_sem done;
+    struct i2c_txn txn = {
+        .bus = bus,
+        .addr = addr,
+        .msgs = msgs,
+        .num_msgs = num_msgs,
+        .cb = i2c_engine_sync_cb,
+        .user_data = &done,
+    };
+    int ret;
+
+    if (bus == NULL)
+    {
+        return -ENODEV;
+    }
+    if (k_current_get() == bus->tid)
+    {
+        return i2c_engine_execute(bus, addr, msgs, num_msgs);
+    }
+
+    k_sem_init(&done, 0, 1);
+    ret = i2c_engine_submit(&txn);
+    if (ret < 0)
+    {
+        return ret;
+    }
+    k_sem_take(&done, K_FOREVER);
+    return txn.result;
+}
+
+int i2c_engine_write(struct i2c_bus *bus, uint16_t addr, const uint8_t *buf,
+                     uint32_t len)
+{
+    struct i2c_msg msg = {
+        .buf = (uint8_t *)buf,
+        .len = len,
+        .flags = I2C_MSG_WRITE | I2C_MSG_STOP,
+    };
+
+    return i2c_engine_transfer(bus, addr, &msg, 1);
+}
+
+int i2c_engine_read(struct i2c_bus *bus, uint16_t addr, uint8_t *buf,
+                    uint32_t len)
+{
+    struct i2c_msg msg = {
+        .buf = buf,
+        .len = len,
+        .flags = I2C_MSG_READ | I2C_MSG_STOP,
+    };
+
+    return i2c_engine_transfer(bus, addr, &msg, 1);
+}
+
+int i2c_engine_write_read(struct i2c_bus *bus, uint16_t addr,
+                          const void *write_buf, size_t num_write,
+                          void *read_buf, size_t num_read)
+{
+    struct i2c_msg msgs[2] = {
+        {
+            .buf = (uint8_t *)write_buf,
+            .len = num_write,
+            .flags = I2C_MSG_WRITE,
+        },
+        {
+            .buf = (uint8_t *)read_buf,
+            .len = num_read,
+            .flags = I2C_MSG_RESTART | I2C_MSG_READ | I2C_MSG_STOP,
+        },
+    };
+
+    return i2c_engine_transfer(bus, addr, msgs, 2);
+}
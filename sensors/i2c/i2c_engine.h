@@ -0,0 +1,74 @@
+#ifndef I2C_ENGINE_H
+#define I2C_ENGINE_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/i2c.h>
+#include "i2c_bus.h"
+
+/* Stack size and priority of the per-bus threads that execute transfers. */
+#define I2C_ENGINE_STACK_SIZE 1024
+#define I2C_ENGINE_PRIORITY K_PRIO_PREEMPT(2)
+
+struct i2c_txn;
+
+/**
+ * Completion callback of a queued transaction. Runs on the bus's engine
+ * thread, so it must not block; it may submit follow-up transactions.
+ *
+ * @param txn    The completed transaction
+ * @param result 0 on success, negative errno from the bus driver otherwise
+ */
+typedef void (*i2c_txn_cb_t)(struct i2c_txn *txn, int result);
+
+struct i2c_txn
+{
+    void *fifo_reserved; /* used by k_fifo, must be first */
+    struct i2c_bus *bus;
+    uint16_t addr;
+    struct i2c_msg *msgs;
+    uint8_t num_msgs;
+    i2c_txn_cb_t cb;
+    void *user_data;
+    int result;
+};
+
+/**
+ * Start the engine thread of a bus. Called once by the bus manager.
+ */
+void i2c_engine_start(struct i2c_bus *bus, k_thread_stack_t *stack,
+                      size_t stack_size);
+
+/**
+ * Queue a transaction on its bus and return immediately. The transaction and
+ * its message buffers must stay valid until the callback has run.
+ *
+ * @param txn Transaction to queue, with bus, addr, msgs, num_msgs and cb set
+ * @returns   0 on success, -EINVAL if the transaction is incomplete
+ */
+int i2c_engine_submit(struct i2c_txn *txn);
+
+/**
+ * Queue a transaction and wait for its completion. Only the calling thread
+ * waits; other work items keep running. When called from the bus's own engine
+ * thread (e.g. from a callback) the transfer is executed in place.
+ *
+ * @returns 0 on success, negative errno otherwise
+ */
+int i2c_engine_transfer(struct i2c_bus *bus, uint16_t addr,
+                        struct i2c_msg *msgs, uint8_t num_msgs);
+
+int i2c_engine_write(struct i2c_bus *bus, uint16_t addr, const uint8_t *buf,
+                     uint32_t len);
+
+int i2c_engine_read(struct i2c_bus *bus, uint16_t addr, uint8_t *buf,
+                    uint32_t len);
+
+/**
+ * Write then read with a repeated start, as one queued transaction.
+ */
+int i2c_engine_write_read(struct i2c_bus *bus, uint16_t addr,
+                          const void *write_buf, size_t num_write,
+                          void *read_buf, size_t num_read);
+
+#endif
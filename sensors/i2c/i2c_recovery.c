@@ -0,0 +1,237 @@
+#include "i2c_recovery.h"
+#include "i2c_bus.h"
+#include "i2c_stats.h"
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+enum i2c_recovery_action
+{
+    I2C_RECOVERY_NONE,
+    I2C_RECOVERY_BUS_CLEAR,
+    I2C_RECOVERY_BUS_RESET,
+};
+
+struct i2c_recovery_device
+{
+    uint16_t addr;
+    uint8_t bus_idx;
+    bool used;
+    bool needs_init;
+    bool quarantined;
+    uint8_t consecutive;
+    uint8_t score;
+    int64_t next_attempt; /* uptime in ms */
+    i2c_recovery_reset_t reset;
+};
+
+static struct i2c_recovery_device devices[I2C_RECOVERY_MAX_DEVICES];
+static int64_t bus_next_recovery[I2C_BUS_MAX];
+static K_MUTEX_DEFINE(recovery_lock);
+
+static struct i2c_recovery_device *find_device(uint8_t bus_idx, uint16_t addr)
+{
+    for (uint8_t i = 0; i < I2C_RECOVERY_MAX_DEVICES; i++)
+    {
+        if (devices[i].used && devices[i].bus_idx == bus_idx && devices[i].addr == addr)
+        {
+            return &devices[i];
+        }
+    }
+    return NULL;
+}
+
+int i2c_recovery_register(uint8_t bus_idx, uint16_t addr, i2c_recovery_reset_t reset)
+{
+    struct i2c_recovery_device *dev;
+    int ret = 0;
+
+    k_mutex_lock(&recovery_lock, K_FOREVER);
+    dev = find_device(bus_idx, addr);
+    for (uint8_t i = 0; dev == NULL && i < I2C_RECOVERY_MAX_DEVICES; i++)
+    {
+        if (!devices[i].used)
+        {
+            dev = &devices[i];
+        }
+    }
+    if (dev == NULL)
+    {
+        ret = -ENOMEM;
+    }
+    else
+    {
+        *dev = (struct i2c_recovery_device){
+            .addr = addr,
+            .bus_idx = bus_idx,
+            .used = true,
+            .needs_init = true,
+            .reset = reset,
+        };
+    }
+    k_mutex_unlock(&recovery_lock);
+    return ret;
+}
+
+bool i2c_recovery_ready(uint8_t bus_idx, uint16_t addr)
+{
+    struct i2c_recovery_device *dev;
+    bool ready = true;
+
+    k_mutex_lock(&recovery_lock, K_FOREVER);
+    dev = find_device(bus_idx, addr);
+    if (dev != NULL && dev->consecutive > 0)
+    {
+        ready = k_uptime_get() >= dev->next_attempt;
+    }
+    k_mutex_unlock(&recovery_lock);
+    return ready;
+}
+
+bool i2c_recovery_needs_init(uint8_t bus_idx, uint16_t addr)
+{
+    struct i2c_recovery_device *dev;
+    bool needs_init;
+
+    k_mutex_lock(&recovery_lock, K_FOREVER);
+    dev = find_device(bus_idx, addr);
+    needs_init = dev != NULL && dev->needs_init;
+    k_mutex_unlock(&recovery_lock);
+    return needs_init;
+}
+
+void i2c_recovery_initialized(uint8_t bus_idx, uint16_t addr)
+{
+    struct i2c_recovery_device *dev;
+
+    k_mutex_lock(&recovery_lock, K_FOREVER);
+    dev = find_device(bus_idx, addr);
+    if (dev != NULL)
+    {
+        dev->needs_init = false;
+    }
+    k_mutex_unlock(&recovery_lock);
+}
+
+static uint32_t backoff_ms(uint8_t consecutive)
+{
+    uint8_t shift = MIN(consecutive - 1, 31);
+    uint64_t ms = (uint64_t)I2C_RECOVERY_BACKOFF_MIN_MS << shift;
+
+    return MIN(ms, I2C_RECOVERY_BACKOFF_MAX_MS);
+}
+
+/* Pick the recovery step for a failed device, at most one per bus and
+ * I2C_RECOVERY_BUS_INTERVAL_MS so recovery cannot monopolize the bus. */
+static enum i2c_recovery_action escalate(struct i2c_recovery_device *dev,
+                                         struct i2c_bus *bus, int64_t now)
+{
+    enum i2c_recovery_action action = I2C_RECOVERY_NONE;
+
+    if (bus == NULL || now < bus_next_recovery[bus->idx])
+    {
+        return I2C_RECOVERY_NONE;
+    }
+    if (dev->reset != NULL && dev->consecutive >= I2C_RECOVERY_RESET_AFTER)
+    {
+        action = I2C_RECOVERY_BUS_RESET;
+    }
+    else if (dev->consecutive >= I2C_RECOVERY_BUS_CLEAR_AFTER)
+    {
+        action = I2C_RECOVERY_BUS_CLEAR;
+    }
+    if (action != I2C_RECOVERY_NONE)
+    {
+        bus_next_recovery[bus->idx] = now + I2C_RECOVERY_BUS_INTERVAL_MS;
+    }
+    return action;
+}
+
+static void mark_bus_reset(struct i2c_bus *bus)
+{
+    k_mutex_lock(&recovery_lock, K_FOREVER);
+    for (uint8_t i = 0; i < I2C_RECOVERY_MAX_DEVICES; i++)
+    {
+        if (devices[i].used && devices[i].bus_idx == bus->idx)
+        {
+            devices[i].needs_init = true;
+        }
+    }
+    k_mutex_unlock(&recovery_lock);
+}
+
+void i2c_recovery_report(uint8_t bus_idx, uint16_t addr, int result)
+{
+    struct i2c_bus *bus = i2c_bus_get(bus_idx);
+    enum i2c_recovery_action action = I2C_RECOVERY_NONE;
+    i2c_recovery_reset_t reset = NULL;
+    struct i2c_recovery_device *dev;
+    int64_t now = k_uptime_get();
+    int ret;
+
+    k_mutex_lock(&recovery_lock, K_FOREVER);
+    dev = find_device(bus_idx, addr);
+    if (dev == NULL)
+    {
+        k_mutex_unlock(&recovery_lock);
+        return;
+    }
+
+    if (result == 0)
+    {
+        if (dev->quarantined)
+        {
+            printk("I2C device %u:0x%02x back from quarantine\n", bus_idx, addr);
+            dev->quarantined = false;
+            /* stay close to the threshold, a relapse quarantines again */
+            dev->score = I2C_RECOVERY_QUARANTINE_SCORE / 2;
+        }
+        else if (dev->score > 0)
+        {
+            dev->score--;
+        }
+        dev->consecutive = 0;
+        k_mutex_unlock(&recovery_lock);
+        return;
+    }
+
+    dev->consecutive = MIN(dev->consecutive + 1, UINT8_MAX);
+    dev->score = MIN(dev->score + 2, I2C_RECOVERY_QUARANTINE_SCORE);
+    if (dev->score >= I2C_RECOVERY_QUARANTINE_SCORE)
+    {
+        if (!dev->quarantined)
+        {
+            printk("I2C device %u:0x%02x quarantined\n", bus_idx, addr);
+        }
+        dev->quarantined = true;
+        dev->next_attempt = now + I2C_RECOVERY_QUARANTINE_MS;
+    }
+    else
+    {
+        dev->next_attempt = now + backoff_ms(dev->consecutive);
+        printk("I2C device %u:0x%02x backing off for %u ms\n", bus_idx, addr,
+               backoff_ms(dev->consecutive));
+    }
+    i2c_stats_expect_retry(bus_idx, addr);
+    action = escalate(dev, bus, now);
+    reset = dev->reset;
+    k_mutex_unlock(&recovery_lock);
+
+    switch (action)
+    {
+    case I2C_RECOVERY_BUS_CLEAR:
+        i2c_bus_lock(bus, K_FOREVER);
+        ret = i2c_recover_bus(bus->dev);
+        i2c_bus_unlock(bus);
+        printk("I2C bus %u cleared for 0x%02x: %d\n", bus->idx, addr, ret);
+        break;
+    case I2C_RECOVERY_BUS_RESET:
+        ret = reset(bus);
+        printk("I2C bus %u reset for 0x%02x: %d\n", bus->idx, addr, ret);
+        mark_bus_reset(bus);
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef I2C_RECOVERY_H
+#define I2C_RECOVERY_H
+
+#include <zephyr/kernel.h>
+#include "i2c_bus.h"
+
+/* Number of devices whose health is tracked. */
+#define I2C_RECOVERY_MAX_DEVICES 8
+/* Backoff after the first failure; doubles with every further one. */
+#define I2C_RECOVERY_BACKOFF_MIN_MS 1000
+#define I2C_RECOVERY_BACKOFF_MAX_MS (5 * 60 * 1000)
+/* Consecutive failures after which the bus is cleared / the device reset. */
+#define I2C_RECOVERY_BUS_CLEAR_AFTER 2
+#define I2C_RECOVERY_RESET_AFTER 4
+/* Minimum time between two recovery actions on the same bus. */
+#define I2C_RECOVERY_BUS_INTERVAL_MS 10000
+/* A failure adds 2 to a device's score and a success takes 1 away, so both
+ * dead and flapping devices reach the quarantine threshold. */
+#define I2C_RECOVERY_QUARANTINE_SCORE 12
+#define I2C_RECOVERY_QUARANTINE_MS (30 * 60 * 1000)
+
+/**
+ * Resets the devices of one bus, e.g. with a general call reset. Every device
+ * on the bus must be initialized again afterwards.
+ */
+typedef int (*i2c_recovery_reset_t)(struct i2c_bus *bus);
+
+/**
+ * Start tracking a device. The device starts out needing initialization.
+ * Devices are told apart by bus and address, so the same address may be
+ * tracked on several buses.
+ *
+ * @param bus_idx Bus index the device is on
+ * @param addr    7-bit device address
+ * @param reset   Bus reset to escalate to, or NULL if there is none
+ * @returns 0 on success, -ENOMEM if the table is full
+ */
+int i2c_recovery_register(uint8_t bus_idx, uint16_t addr, i2c_recovery_reset_t reset);
+
+/**
+ * Check whether a device may be accessed now. Devices backing off or in
+ * quarantine are skipped until their next attempt is due, so the caller can
+ * go on with the other devices.
+ */
+bool i2c_recovery_ready(uint8_t bus_idx, uint16_t addr);
+
+/**
+ * Check whether a device has to be (re)initialized before it is read: at
+ * startup, and after its bus was reset.
+ */
+bool i2c_recovery_needs_init(uint8_t bus_idx, uint16_t addr);
+
+/**
+ * Mark a device as initialized.
+ */
+void i2c_recovery_initialized(uint8_t bus_idx, uint16_t addr);
+
+/**
+ * Report the outcome of an access to a device. Failures schedule the next
+ * attempt with exponential backoff and escalate to a bus clear and a bus
+ * reset, rate limited per bus; devices that keep failing are quarantined.
+ *
+ * @param result 0 on success, any other value is a failure
+ */
+void i2c_recovery_report(uint8_t bus_idx, uint16_t addr, int result);
+
+#endif
@@ -0,0 +1,270 @@
+#include "i2c_stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+enum i2c_stats_counter
+{
+    I2C_STATS_TRANSACTIONS,
+    I2C_STATS_BYTES,
+    I2C_STATS_NACKS,
+    I2C_STATS_BUS_ERRORS,
+    I2C_STATS_CRC_ERRORS,
+    I2C_STATS_RETRIES,
+    I2C_STATS_NUM_COUNTERS,
+};
+
+struct i2c_stats_device
+{
+    atomic_t counters[I2C_STATS_NUM_COUNTERS];
+    atomic_t latency_hist[I2C_STATS_LATENCY_BUCKETS];
+};
+
+/* Slot keys are shared by all CPUs, counters are kept per CPU so that cores
+ * never contend on the same cache line; readers sum them up. */
+static atomic_t slot_keys[I2C_STATS_MAX_DEVICES];
+static struct i2c_stats_device stats[CONFIG_MP_MAX_NUM_CPUS][I2C_STATS_MAX_DEVICES];
+/* The next transfer of the slot retries a failed access */
+static atomic_t retry_pending[I2C_STATS_MAX_DEVICES];
+
+static inline atomic_val_t slot_key(uint8_t bus, uint16_t addr)
+{
+    return ((atomic_val_t)(bus + 1) << 16) | addr;
+}
+
+static inline struct i2c_stats_device *cpu_stats(int slot)
+{
+#if CONFIG_MP_MAX_NUM_CPUS > 1
+    return &stats[arch_curr_cpu()->id][slot];
+#else
+    return &stats[0][slot];
+#endif
+}
+
+static int find_slot(uint8_t bus, uint16_t addr)
+{
+    atomic_val_t key = slot_key(bus, addr);
+
+    for (int i = 0; i < I2C_STATS_MAX_DEVICES; i++)
+    {
+        if (atomic_get(&slot_keys[i]) == key ||
+            atomic_cas(&slot_keys[i], 0, key) ||
+            atomic_get(&slot_keys[i]) == key)
+        {
+            return i;
+        }
+    }
+    return -ENOMEM;
+}
+
+static uint8_t latency_bucket(uint32_t latency_us)
+{
+    uint8_t bucket = latency_us ? 32 - __builtin_clz(latency_us) : 0;
+
+    return MIN(bucket, I2C_STATS_LATENCY_BUCKETS - 1);
+}
+
+void i2c_stats_record_transfer(uint8_t bus, uint16_t addr, uint32_t bytes,
+                               uint32_t latency_us, int result)
+{
+    int slot = find_slot(bus, addr);
+    struct i2c_stats_device *dev;
+
+    if (slot < 0)
+    {
+        return;
+    }
+    dev = cpu_stats(slot);
+
+    atomic_inc(&dev->counters[I2C_STATS_TRANSACTIONS]);
+    if (atomic_clear(&retry_pending[slot]))
+    {
+        atomic_inc(&dev->counters[I2C_STATS_RETRIES]);
+    }
+    atomic_inc(&dev->latency_hist[latency_bucket(latency_us)]);
+    if (result == 0)
+    {
+        atomic_add(&dev->counters[I2C_STATS_BYTES], bytes);
+    }
+    else if (result == -EIO)
+    {
+        atomic_inc(&dev->counters[I2C_STATS_NACKS]);
+    }
+    else
+    {
+        atomic_inc(&dev->counters[I2C_STATS_BUS_ERRORS]);
+    }
+}
+
+void i2c_stats_record_crc_error(uint8_t bus, uint16_t addr)
+{
+    int slot = find_slot(bus, addr);
+
+    if (slot >= 0)
+    {
+        atomic_inc(&cpu_stats(slot)->counters[I2C_STATS_CRC_ERRORS]);
+    }
+}
+
+void i2c_stats_expect_retry(uint8_t bus, uint16_t addr)
+{
+    int slot = find_slot(bus, addr);
+
+    if (slot >= 0)
+    {
+        atomic_set(&retry_pending[slot], 1);
+    }
+}
+
+int i2c_stats_get(uint8_t n, struct i2c_stats_snapshot *out)
+{
+    uint32_t counters[I2C_STATS_NUM_COUNTERS] = {0};
+    atomic_val_t key;
+
+    if (n >= I2C_STATS_MAX_DEVICES)
+    {
+        return -ENOENT;
+    }
+    key = atomic_get(&slot_keys[n]);
+    if (key == 0)
+    {
+        return -ENOENT;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->bus = (key >> 16) - 1;
+    out->addr = key & 0xFFFF;
+    for (int cpu = 0; cpu < CONFIG_MP_MAX_NUM_CPUS; cpu++)
+    {
+        for (int c = 0; c < I2C_STATS_NUM_COUNTERS; c++)
+        {
+            counters[c] += atomic_get(&stats[cpu][n].counters[c]);
+        }
+        for (int b = 0; b < I2C_STATS_LATENCY_BUCKETS; b++)
+        {
+            out->latency_hist[b] += atomic_get(&stats[cpu][n].latency_hist[b]);
+        }
+    }
+    out->transactions = counters[I2C_STATS_TRANSACTIONS];
+    out->bytes = counters[I2C_STATS_BYTES];
+    out->nacks = counters[I2C_STATS_NACKS];
+    out->bus_errors = counters[I2C_STATS_BUS_ERRORS];
+    out->crc_errors = counters[I2C_STATS_CRC_ERRORS];
+    out->retries = counters[I2C_STATS_RETRIES];
+    return 0;
+}
+
+void i2c_stats_reset(void)
+{
+    for (int cpu = 0; cpu < CONFIG_MP_MAX_NUM_CPUS; cpu++)
+    {
+        for (int n = 0; n < I2C_STATS_MAX_DEVICES; n++)
+        {
+            for (int c = 0; c < I2C_STATS_NUM_COUNTERS; c++)
+            {
+                atomic_clear(&stats[cpu][n].counters[c]);
+            }
+            for (int b = 0; b < I2C_STATS_LATENCY_BUCKETS; b++)
+            {
+                atomic_clear(&stats[cpu][n].latency_hist[b]);
+            }
+        }
+    }
+}
+
+int i2c_stats_to_json(char *buf, size_t len)
+{
+    struct i2c_stats_snapshot s;
+    size_t pos = 0;
+    int ret;
+
+#define APPEND(...)                                                 \
+    do                                                              \
+    {                                                               \
+        ret = snprintf(&buf[pos], len - pos, __VA_ARGS__);          \
+        if (ret < 0 || (size_t)ret >= len - pos)                    \
+        {                                                           \
+            return -ENOMEM;                                         \
+        }                                                           \
+        pos += ret;                                                 \
+    } while (0)
+
+    if (len == 0)
+    {
+        return -ENOMEM;
+    }
+
+    APPEND("[");
+    for (uint8_t n = 0; n < I2C_STATS_MAX_DEVICES; n++)
+    {
+        if (i2c_stats_get(n, &s) != 0)
+        {
+            continue;
+        }
+        APPEND("%s{\"bus\":%u,\"addr\":%u,\"tx\":%u,\"bytes\":%u,\"nack\":%u,"
+               "\"err\":%u,\"crc\":%u,\"retry\":%u,\"lat\":[",
+               pos > 1 ? "," : "", s.bus, s.addr, s.transactions, s.bytes,
+               s.nacks, s.bus_errors, s.crc_errors, s.retries);
+        for (int b = 0; b < I2C_STATS_LATENCY_BUCKETS; b++)
+        {
+            APPEND("%s%u", b ? "," : "", s.latency_hist[b]);
+        }
+        APPEND("]}");
+    }
+    APPEND("]");
+
+#undef APPEND
+    return pos;
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_i2cstats_show(const struct shell *sh, size_t argc, char **argv)
+{
+    struct i2c_stats_snapshot s;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    for (uint8_t n = 0; n < I2C_STATS_MAX_DEVICES; n++)
+    {
+        if (i2c_stats_get(n, &s) != 0)
+        {
+            continue;
+        }
+        shell_print(sh, "i2c%u 0x%02x: %u transfers, %u bytes, %u nack, "
+                        "%u bus errors, %u crc errors, %u retries",
+                    s.bus, s.addr, s.transactions, s.bytes, s.nacks,
+                    s.bus_errors, s.crc_errors, s.retries);
+        for (int b = 0; b < I2C_STATS_LATENCY_BUCKETS; b++)
+        {
+            if (s.latency_hist[b])
+            {
+                shell_print(sh, "  < %6u us: %u", 1U << b, s.latency_hist[b]);
+            }
+        }
+    }
+    return 0;
+}
+
+static int cmd_i2cstats_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    i2c_stats_reset();
+    shell_print(sh, "I2C statistics cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_i2cstats,
+    SHELL_CMD(show, NULL, "Show per-device I2C statistics", cmd_i2cstats_show),
+    SHELL_CMD(reset, NULL, "Clear I2C statistics", cmd_i2cstats_reset),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(i2cstats, &sub_i2cstats, "I2C bus telemetry", NULL);
+#endif /* CONFIG_SHELL */
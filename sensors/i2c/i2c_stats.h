@@ -0,0 +1,74 @@
+#ifndef I2C_STATS_H
+#define I2C_STATS_H
+
+#include <zephyr/kernel.h>
+
+/* Number of (bus, address) pairs tracked; further devices are not counted. */
+#define I2C_STATS_MAX_DEVICES 8
+/* Latency buckets: bucket n counts transfers of [2^(n-1), 2^n) us, bucket 0
+ * those under 1 us; the last bucket also takes everything slower. */
+#define I2C_STATS_LATENCY_BUCKETS 16
+
+/**
+ * Counters of one device, summed over all CPUs.
+ */
+struct i2c_stats_snapshot
+{
+    uint8_t bus;
+    uint16_t addr;
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t nacks;      /* transfers failing with -EIO (address/data NACK) */
+    uint32_t bus_errors; /* transfers failing with any other error */
+    uint32_t crc_errors;
+    uint32_t retries;
+    uint32_t latency_hist[I2C_STATS_LATENCY_BUCKETS];
+};
+
+/**
+ * Record one completed transfer. Lock-free; callable from any thread.
+ *
+ * @param bus        Bus index
+ * @param addr       7-bit device address
+ * @param bytes      Bytes moved in all messages of the transfer
+ * @param latency_us Time spent on the bus
+ * @param result     Return value of the transfer
+ */
+void i2c_stats_record_transfer(uint8_t bus, uint16_t addr, uint32_t bytes,
+                               uint32_t latency_us, int result);
+
+/**
+ * Record a checksum failure in data received from a device.
+ *
+ * @param bus  Bus index
+ * @param addr 7-bit device address
+ */
+void i2c_stats_record_crc_error(uint8_t bus, uint16_t addr);
+
+/**
+ * Record that an access to a device failed. The next transfer to the device
+ * is counted as its retry, however long the device backs off before it.
+ */
+void i2c_stats_expect_retry(uint8_t bus, uint16_t addr);
+
+/**
+ * Read the counters of the n-th tracked device.
+ *
+ * @returns 0 on success, -ENOENT if no device is tracked in that slot
+ */
+int i2c_stats_get(uint8_t n, struct i2c_stats_snapshot *out);
+
+/**
+ * Clear all counters. Devices stay tracked.
+ */
+void i2c_stats_reset(void);
+
+/**
+ * Write all counters as a JSON array into buf.
+ *
+ * @returns number of characters written (excluding the terminator), or
+ *          -ENOMEM if buf is too small
+ */
+int i2c_stats_to_json(char *buf, size_t len);
+
+#endif
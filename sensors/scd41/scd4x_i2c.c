@@ -1,5 +1,6 @@
 /*
- * THIS FILE IS AUTOMATICALLY GENERATED AND MUST NOT BE EDITED MANUALLY!
+ * Derived from the output of the Sensirion I2C generator and maintained by
+ * hand since; regenerating it would drop the local changes.
  *
  * I2C-Generator: 0.2.0
  * Yaml Version: 0.1.0
@@ -37,47 +38,153 @@
  */
 
 #include "scd4x_i2c.h"
+#include "sensirion_i2c_cmd.h"
 #include "sensirion_common.h"
 #include "sensirion_i2c.h"
 #include "sensirion_i2c_hal.h"
 
-#define SCD4X_I2C_ADDRESS 98
+enum scd4x_cmd_id {
+    SCD4X_CMD_START_PERIODIC_MEASUREMENT,
+    SCD4X_CMD_READ_MEASUREMENT,
+    SCD4X_CMD_STOP_PERIODIC_MEASUREMENT,
+    SCD4X_CMD_GET_TEMPERATURE_OFFSET,
+    SCD4X_CMD_SET_TEMPERATURE_OFFSET,
+    SCD4X_CMD_GET_SENSOR_ALTITUDE,
+    SCD4X_CMD_SET_SENSOR_ALTITUDE,
+    SCD4X_CMD_SET_AMBIENT_PRESSURE,
+    SCD4X_CMD_PERFORM_FORCED_RECALIBRATION,
+    SCD4X_CMD_GET_AUTOMATIC_SELF_CALIBRATION,
+    SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION,
+    SCD4X_CMD_START_LOW_POWER_PERIODIC_MEASUREMENT,
+    SCD4X_CMD_GET_DATA_READY_FLAG,
+    SCD4X_CMD_PERSIST_SETTINGS,
+    SCD4X_CMD_GET_SERIAL_NUMBER,
+    SCD4X_CMD_PERFORM_SELF_TEST,
+    SCD4X_CMD_PERFORM_FACTORY_RESET,
+    SCD4X_CMD_REINIT,
+    SCD4X_CMD_MEASURE_SINGLE_SHOT,
+    SCD4X_CMD_MEASURE_SINGLE_SHOT_RHT_ONLY,
+    SCD4X_CMD_POWER_DOWN,
+    SCD4X_CMD_WAKE_UP,
+};
+
+/* opcode, argument words, response words, execution time in us */
+static const struct sensirion_i2c_cmd_desc scd4x_cmds[] = {
+    [SCD4X_CMD_START_PERIODIC_MEASUREMENT] =
+        SENSIRION_I2C_CMD_DESC(0x21B1, 0, 0, 1000),
+    [SCD4X_CMD_READ_MEASUREMENT] = SENSIRION_I2C_CMD_DESC_FRAME(0xEC05, 3, 1000),
+    [SCD4X_CMD_STOP_PERIODIC_MEASUREMENT] =
+        SENSIRION_I2C_CMD_DESC(0x3F86, 0, 0, 500000),
+    [SCD4X_CMD_GET_TEMPERATURE_OFFSET] =
+        SENSIRION_I2C_CMD_DESC(0x2318, 0, 1, 1000),
+    [SCD4X_CMD_SET_TEMPERATURE_OFFSET] =
+        SENSIRION_I2C_CMD_DESC(0x241D, 1, 0, 1000),
+    [SCD4X_CMD_GET_SENSOR_ALTITUDE] = SENSIRION_I2C_CMD_DESC(0x2322, 0, 1, 1000),
+    [SCD4X_CMD_SET_SENSOR_ALTITUDE] = SENSIRION_I2C_CMD_DESC(0x2427, 1, 0, 1000),
+    [SCD4X_CMD_SET_AMBIENT_PRESSURE] =
+        SENSIRION_I2C_CMD_DESC(0xE000, 1, 0, 1000),
+    [SCD4X_CMD_PERFORM_FORCED_RECALIBRATION] =
+        SENSIRION_I2C_CMD_DESC(0x362F, 1, 1, 400000),
+    [SCD4X_CMD_GET_AUTOMATIC_SELF_CALIBRATION] =
+        SENSIRION_I2C_CMD_DESC(0x2313, 0, 1, 1000),
+    [SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION] =
+        SENSIRION_I2C_CMD_DESC(0x2416, 1, 0, 1000),
+    [SCD4X_CMD_START_LOW_POWER_PERIODIC_MEASUREMENT] =
+        SENSIRION_I2C_CMD_DESC(0x21AC, 0, 0, 0),
+    [SCD4X_CMD_GET_DATA_READY_FLAG] = SENSIRION_I2C_CMD_DESC(0xE4B8, 0, 1, 1000),
+    [SCD4X_CMD_PERSIST_SETTINGS] = SENSIRION_I2C_CMD_DESC(0x3615, 0, 0, 800000),
+    [SCD4X_CMD_GET_SERIAL_NUMBER] = SENSIRION_I2C_CMD_DESC(0x3682, 0, 3, 1000),
+    [SCD4X_CMD_PERFORM_SELF_TEST] =
+        SENSIRION_I2C_CMD_DESC(0x3639, 0, 1, 10000000),
+    [SCD4X_CMD_PERFORM_FACTORY_RESET] =
+        SENSIRION_I2C_CMD_DESC(0x3632, 0, 0, 800000),
+    [SCD4X_CMD_REINIT] = SENSIRION_I2C_CMD_DESC(0x3646, 0, 0, 20000),
+    [SCD4X_CMD_MEASURE_SINGLE_SHOT] =
+        SENSIRION_I2C_CMD_DESC(0x219D, 0, 0, 5000000),
+    [SCD4X_CMD_MEASURE_SINGLE_SHOT_RHT_ONLY] =
+        SENSIRION_I2C_CMD_DESC(0x2196, 0, 0, 50000),
+    [SCD4X_CMD_POWER_DOWN] = SENSIRION_I2C_CMD_DESC(0x36E0, 0, 0, 1000),
+    [SCD4X_CMD_WAKE_UP] = SENSIRION_I2C_CMD_DESC(0x36F6, 0, 0, 20000),
+};
 
-int16_t scd4x_start_periodic_measurement() {
+/*
+ * Measurement phase of the running periodic measurement. It is learned from
+ * the data ready flag; afterwards each measurement is read right after its
+ * expected completion without asking the sensor first. A read the sensor
+ * NACKs because its clock drifted behind the schedule drops the lock and the
+ * phase is learned again.
+ */
+static struct {
+    uint32_t interval_ms; /* 0 if no periodic measurement is running */
+    bool locked;
+    int64_t next_ready; /* uptime of the next completion if locked, ms */
+} scd4x_phase;
+
+static void scd4x_phase_reset(uint32_t interval_ms) {
+    scd4x_phase.interval_ms = interval_ms;
+    scd4x_phase.locked = false;
+}
+
+static int16_t scd4x_cmd(enum scd4x_cmd_id id, const uint16_t* args,
+                         uint8_t* rx_buf) {
+    return sensirion_i2c_cmd_run(SCD4X_I2C_ADDRESS, &scd4x_cmds[id], args,
+                                 rx_buf);
+}
+
+static int16_t scd4x_write(enum scd4x_cmd_id id, uint16_t arg) {
+    return scd4x_cmd(id, &arg, NULL);
+}
+
+static int16_t scd4x_read_word(enum scd4x_cmd_id id, const uint16_t* args,
+                               uint16_t* word) {
     int16_t error;
-    uint8_t buffer[2];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x21B1);
+    uint8_t buffer[SENSIRION_WORD_SIZE + CRC8_LEN];
 
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
+    error = scd4x_cmd(id, args, &buffer[0]);
     if (error) {
         return error;
     }
-    sensirion_i2c_hal_sleep_usec(1000);
+    *word = sensirion_common_bytes_to_uint16_t(&buffer[0]);
     return NO_ERROR;
 }
 
-int16_t scd4x_read_measurement_ticks(uint16_t* co2, uint16_t* temperature,
-                                     uint16_t* humidity) {
+int16_t scd4x_start_periodic_measurement() {
+    int16_t error = scd4x_cmd(SCD4X_CMD_START_PERIODIC_MEASUREMENT, NULL, NULL);
+
+    scd4x_phase_reset(error ? 0 : SCD4X_PERIODIC_INTERVAL_MS);
+    return error;
+}
+
+_Static_assert(sizeof(struct scd4x_measurement_ticks) == 3 * sizeof(uint16_t),
+               "scd4x_measurement_ticks must match the sensor's word order");
+
+int16_t scd4x_read_measurement_frame(struct scd4x_measurement_ticks* ticks) {
     int16_t error;
-    uint8_t buffer[9];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0xEC05);
+    uint8_t buffer[3 * (SENSIRION_WORD_SIZE + CRC8_LEN)];
 
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
+    error = scd4x_cmd(SCD4X_CMD_READ_MEASUREMENT, NULL, &buffer[0]);
     if (error) {
         return error;
     }
+    error = sensirion_i2c_decode_uint16(&buffer[0], 3, &ticks->co2);
+    if (error == CRC_ERROR) {
+        sensirion_i2c_report_crc_error(SCD4X_I2C_ADDRESS, &buffer[0], 3);
+    }
+    return error;
+}
 
-    sensirion_i2c_hal_sleep_usec(1000);
+int16_t scd4x_read_measurement_ticks(uint16_t* co2, uint16_t* temperature,
+                                     uint16_t* humidity) {
+    int16_t error;
+    struct scd4x_measurement_ticks ticks;
 
-    error = sensirion_i2c_read_data_inplace(SCD4X_I2C_ADDRESS, &buffer[0], 6);
+    error = scd4x_read_measurement_frame(&ticks);
     if (error) {
         return error;
     }
-    *co2 = sensirion_common_bytes_to_uint16_t(&buffer[0]);
-    *temperature = sensirion_common_bytes_to_uint16_t(&buffer[2]);
-    *humidity = sensirion_common_bytes_to_uint16_t(&buffer[4]);
+    *co2 = ticks.co2;
+    *temperature = ticks.temperature;
+    *humidity = ticks.humidity;
     return NO_ERROR;
 }
 
@@ -96,41 +203,91 @@ int16_t scd4x_read_measurement(uint16_t* co2, int32_t* temperature_m_deg_c,
     return NO_ERROR;
 }
 
-int16_t scd4x_stop_periodic_measurement() {
+int32_t scd4x_ms_until_ready(void) {
+    int64_t wait;
+
+    if (!scd4x_phase.locked) {
+        return 0;
+    }
+    wait = scd4x_phase.next_ready + SCD4X_PHASE_GUARD_MS - k_uptime_get();
+    return wait > 0 ? (int32_t)wait : 0;
+}
+
+int32_t scd4x_ms_until_idle(void) {
+    return sensirion_i2c_cmd_ms_until_idle(SCD4X_I2C_ADDRESS);
+}
+
+/*
+ * Poll the flag while the phase is unknown. A sample found ready completed at
+ * or before now, so taking now as its completion never schedules a read too
+ * early. The schedule is exact when the flag rose since the previous poll and
+ * at worst one interval late, which costs freshness but no extra traffic.
+ */
+static int16_t scd4x_phase_sync(void) {
     int16_t error;
-    uint8_t buffer[2];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x3F86);
+    bool ready = false;
 
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
+    error = scd4x_get_data_ready_flag(&ready);
     if (error) {
         return error;
     }
-    sensirion_i2c_hal_sleep_usec(500000);
+    if (!ready) {
+        return -EAGAIN;
+    }
+    scd4x_phase.locked = true;
+    scd4x_phase.next_ready = k_uptime_get();
     return NO_ERROR;
 }
 
-int16_t scd4x_get_temperature_offset_ticks(uint16_t* t_offset) {
+int16_t scd4x_read_measurement_aligned(uint16_t* co2,
+                                       int32_t* temperature_m_deg_c,
+                                       int32_t* humidity_m_percent_rh) {
+    int64_t now = k_uptime_get();
+    int64_t latest;
     int16_t error;
-    uint8_t buffer[3];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x2318);
+    bool ready = false;
 
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
+    if (scd4x_phase.interval_ms == 0) {
+        return scd4x_read_measurement(co2, temperature_m_deg_c,
+                                      humidity_m_percent_rh);
+    }
+    if (!scd4x_phase.locked) {
+        error = scd4x_phase_sync();
+        if (error) {
+            return error;
+        }
+    } else if (now < scd4x_phase.next_ready + SCD4X_PHASE_GUARD_MS) {
+        return -EAGAIN;
     }
 
-    sensirion_i2c_hal_sleep_usec(1000);
-
-    error = sensirion_i2c_read_data_inplace(SCD4X_I2C_ADDRESS, &buffer[0], 2);
+    error = scd4x_read_measurement(co2, temperature_m_deg_c,
+                                   humidity_m_percent_rh);
     if (error) {
+        /* A NACK because the measurement is late means the phase drifted */
+        if (scd4x_get_data_ready_flag(&ready) == NO_ERROR && !ready) {
+            scd4x_phase.locked = false;
+            return -EAGAIN;
+        }
         return error;
     }
-    *t_offset = sensirion_common_bytes_to_uint16_t(&buffer[0]);
+
+    /* the sample read is the latest completion at or before now */
+    latest = scd4x_phase.next_ready +
+             (now - scd4x_phase.next_ready) / scd4x_phase.interval_ms *
+                 scd4x_phase.interval_ms;
+    scd4x_phase.next_ready = latest + scd4x_phase.interval_ms;
     return NO_ERROR;
 }
 
+int16_t scd4x_stop_periodic_measurement() {
+    scd4x_phase_reset(0);
+    return scd4x_cmd(SCD4X_CMD_STOP_PERIODIC_MEASUREMENT, NULL, NULL);
+}
+
+int16_t scd4x_get_temperature_offset_ticks(uint16_t* t_offset) {
+    return scd4x_read_word(SCD4X_CMD_GET_TEMPERATURE_OFFSET, NULL, t_offset);
+}
+
 int16_t scd4x_get_temperature_offset(int32_t* t_offset_m_deg_c) {
     int16_t error;
     uint16_t t_offset;
@@ -144,19 +301,7 @@ int16_t scd4x_get_temperature_offset(int32_t* t_offset_m_deg_c) {
 }
 
 int16_t scd4x_set_temperature_offset_ticks(uint16_t t_offset) {
-    int16_t error;
-    uint8_t buffer[5];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x241D);
-
-    offset = sensirion_i2c_add_uint16_t_to_buffer(&buffer[0], offset, t_offset);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-    sensirion_i2c_hal_sleep_usec(1000);
-    return NO_ERROR;
+    return scd4x_write(SCD4X_CMD_SET_TEMPERATURE_OFFSET, t_offset);
 }
 
 int16_t scd4x_set_temperature_offset(int32_t t_offset_m_deg_c) {
@@ -165,183 +310,64 @@ int16_t scd4x_set_temperature_offset(int32_t t_offset_m_deg_c) {
 }
 
 int16_t scd4x_get_sensor_altitude(uint16_t* sensor_altitude) {
-    int16_t error;
-    uint8_t buffer[3];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x2322);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-
-    sensirion_i2c_hal_sleep_usec(1000);
-
-    error = sensirion_i2c_read_data_inplace(SCD4X_I2C_ADDRESS, &buffer[0], 2);
-    if (error) {
-        return error;
-    }
-    *sensor_altitude = sensirion_common_bytes_to_uint16_t(&buffer[0]);
-    return NO_ERROR;
+    return scd4x_read_word(SCD4X_CMD_GET_SENSOR_ALTITUDE, NULL,
+                           sensor_altitude);
 }
 
 int16_t scd4x_set_sensor_altitude(uint16_t sensor_altitude) {
-    int16_t error;
-    uint8_t buffer[5];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x2427);
-
-    offset = sensirion_i2c_add_uint16_t_to_buffer(&buffer[0], offset,
-                                                  sensor_altitude);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-    sensirion_i2c_hal_sleep_usec(1000);
-    return NO_ERROR;
+    return scd4x_write(SCD4X_CMD_SET_SENSOR_ALTITUDE, sensor_altitude);
 }
 
 int16_t scd4x_set_ambient_pressure(uint16_t ambient_pressure) {
-    int16_t error;
-    uint8_t buffer[5];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0xE000);
-
-    offset = sensirion_i2c_add_uint16_t_to_buffer(&buffer[0], offset,
-                                                  ambient_pressure);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-    sensirion_i2c_hal_sleep_usec(1000);
-    return NO_ERROR;
+    return scd4x_write(SCD4X_CMD_SET_AMBIENT_PRESSURE, ambient_pressure);
 }
 
 int16_t scd4x_perform_forced_recalibration(uint16_t target_co2_concentration,
                                            uint16_t* frc_correction) {
-    int16_t error;
-    uint8_t buffer[5];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x362F);
-
-    offset = sensirion_i2c_add_uint16_t_to_buffer(&buffer[0], offset,
-                                                  target_co2_concentration);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-
-    sensirion_i2c_hal_sleep_usec(400000);
-
-    error = sensirion_i2c_read_data_inplace(SCD4X_I2C_ADDRESS, &buffer[0], 2);
-    if (error) {
-        return error;
-    }
-    *frc_correction = sensirion_common_bytes_to_uint16_t(&buffer[0]);
-    return NO_ERROR;
+    return scd4x_read_word(SCD4X_CMD_PERFORM_FORCED_RECALIBRATION,
+                           &target_co2_concentration, frc_correction);
 }
 
 int16_t scd4x_get_automatic_self_calibration(uint16_t* asc_enabled) {
-    int16_t error;
-    uint8_t buffer[3];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x2313);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-
-    sensirion_i2c_hal_sleep_usec(1000);
-
-    error = sensirion_i2c_read_data_inplace(SCD4X_I2C_ADDRESS, &buffer[0], 2);
-    if (error) {
-        return error;
-    }
-    *asc_enabled = sensirion_common_bytes_to_uint16_t(&buffer[0]);
-    return NO_ERROR;
+    return scd4x_read_word(SCD4X_CMD_GET_AUTOMATIC_SELF_CALIBRATION, NULL,
+                           asc_enabled);
 }
 
 int16_t scd4x_set_automatic_self_calibration(uint16_t asc_enabled) {
-    int16_t error;
-    uint8_t buffer[5];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x2416);
-
-    offset =
-        sensirion_i2c_add_uint16_t_to_buffer(&buffer[0], offset, asc_enabled);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-    sensirion_i2c_hal_sleep_usec(1000);
-    return NO_ERROR;
+    return scd4x_write(SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION, asc_enabled);
 }
 
 int16_t scd4x_start_low_power_periodic_measurement() {
-    uint8_t buffer[2];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x21AC);
+    int16_t error =
+        scd4x_cmd(SCD4X_CMD_START_LOW_POWER_PERIODIC_MEASUREMENT, NULL, NULL);
 
-    return sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
+    scd4x_phase_reset(error ? 0 : SCD4X_LOW_POWER_INTERVAL_MS);
+    return error;
 }
 
 int16_t scd4x_get_data_ready_flag(bool* data_ready_flag) {
     int16_t error;
-    uint8_t buffer[3];
-    uint16_t offset = 0;
     uint16_t local_data_ready = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0xE4B8);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-
-    sensirion_i2c_hal_sleep_usec(1000);
 
-    error = sensirion_i2c_read_data_inplace(SCD4X_I2C_ADDRESS, &buffer[0], 2);
+    error = scd4x_read_word(SCD4X_CMD_GET_DATA_READY_FLAG, NULL,
+                            &local_data_ready);
     if (error) {
         return error;
     }
-    local_data_ready = sensirion_common_bytes_to_uint16_t(&buffer[0]);
     *data_ready_flag = (local_data_ready & 0x07FF) != 0;
     return NO_ERROR;
 }
 
 int16_t scd4x_persist_settings() {
-    int16_t error;
-    uint8_t buffer[2];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x3615);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-    sensirion_i2c_hal_sleep_usec(800000);
-    return NO_ERROR;
+    return scd4x_cmd(SCD4X_CMD_PERSIST_SETTINGS, NULL, NULL);
 }
 
 int16_t scd4x_get_serial_number(uint16_t* serial_0, uint16_t* serial_1,
                                 uint16_t* serial_2) {
     int16_t error;
-    uint8_t buffer[9];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x3682);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-
-    sensirion_i2c_hal_sleep_usec(1000);
+    uint8_t buffer[3 * (SENSIRION_WORD_SIZE + CRC8_LEN)];
 
-    error = sensirion_i2c_read_data_inplace(SCD4X_I2C_ADDRESS, &buffer[0], 6);
+    error = scd4x_cmd(SCD4X_CMD_GET_SERIAL_NUMBER, NULL, &buffer[0]);
     if (error) {
         return error;
     }
@@ -352,103 +378,34 @@ int16_t scd4x_get_serial_number(uint16_t* serial_0, uint16_t* serial_1,
 }
 
 int16_t scd4x_perform_self_test(uint16_t* sensor_status) {
-    int16_t error;
-    uint8_t buffer[3];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x3639);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-
-    sensirion_i2c_hal_sleep_usec(10000000);
-
-    error = sensirion_i2c_read_data_inplace(SCD4X_I2C_ADDRESS, &buffer[0], 2);
-    if (error) {
-        return error;
-    }
-    *sensor_status = sensirion_common_bytes_to_uint16_t(&buffer[0]);
-    return NO_ERROR;
+    return scd4x_read_word(SCD4X_CMD_PERFORM_SELF_TEST, NULL, sensor_status);
 }
 
 int16_t scd4x_perform_factory_reset() {
-    int16_t error;
-    uint8_t buffer[2];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x3632);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-    sensirion_i2c_hal_sleep_usec(800000);
-    return NO_ERROR;
+    scd4x_phase_reset(0);
+    return scd4x_cmd(SCD4X_CMD_PERFORM_FACTORY_RESET, NULL, NULL);
 }
 
 int16_t scd4x_reinit() {
-    int16_t error;
-    uint8_t buffer[2];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x3646);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-    sensirion_i2c_hal_sleep_usec(20000);
-    return NO_ERROR;
+    scd4x_phase_reset(0);
+    return scd4x_cmd(SCD4X_CMD_REINIT, NULL, NULL);
 }
 
 int16_t scd4x_measure_single_shot() {
-    int16_t error;
-    uint8_t buffer[2];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x219D);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-    sensirion_i2c_hal_sleep_usec(5000000);
-    return NO_ERROR;
+    return scd4x_cmd(SCD4X_CMD_MEASURE_SINGLE_SHOT, NULL, NULL);
 }
 
 int16_t scd4x_measure_single_shot_rht_only() {
-    int16_t error;
-    uint8_t buffer[2];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x2196);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-    sensirion_i2c_hal_sleep_usec(50000);
-    return NO_ERROR;
+    return scd4x_cmd(SCD4X_CMD_MEASURE_SINGLE_SHOT_RHT_ONLY, NULL, NULL);
 }
 
 int16_t scd4x_power_down() {
-    int16_t error;
-    uint8_t buffer[2];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x36E0);
-
-    error = sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    if (error) {
-        return error;
-    }
-    sensirion_i2c_hal_sleep_usec(1000);
-    return NO_ERROR;
+    scd4x_phase_reset(0);
+    return scd4x_cmd(SCD4X_CMD_POWER_DOWN, NULL, NULL);
 }
 
 int16_t scd4x_wake_up() {
-    uint8_t buffer[2];
-    uint16_t offset = 0;
-    offset = sensirion_i2c_add_command_to_buffer(&buffer[0], offset, 0x36F6);
-
     // Sensor does not acknowledge the wake-up call, error is ignored
-    (void)sensirion_i2c_write_data(SCD4X_I2C_ADDRESS, &buffer[0], offset);
-    sensirion_i2c_hal_sleep_usec(20000);
+    (void)scd4x_cmd(SCD4X_CMD_WAKE_UP, NULL, NULL);
     return NO_ERROR;
 }
@@ -1,5 +1,6 @@
 /*
- * THIS FILE IS AUTOMATICALLY GENERATED AND MUST NOT BE EDITED MANUALLY!
+ * Derived from the output of the Sensirion I2C generator and maintained by
+ * hand since; regenerating it would drop the local changes.
  *
  * I2C-Generator: 0.2.0
  * Yaml Version: 0.1.0
@@ -45,6 +46,23 @@ extern "C" {
 
 #include "sensirion_config.h"
 
+#define SCD4X_I2C_ADDRESS 98
+
+/* Signal update intervals of the periodic measurement modes. */
+#define SCD4X_PERIODIC_INTERVAL_MS 5000
+#define SCD4X_LOW_POWER_INTERVAL_MS 30000
+/* Margin after the expected completion before a measurement is read. */
+#define SCD4X_PHASE_GUARD_MS 50
+/* Duration of a single shot measurement. */
+#define SCD4X_SINGLE_SHOT_MS 5000
+
+/* Raw measurement words in the order the sensor sends them. */
+struct scd4x_measurement_ticks {
+    uint16_t co2;
+    uint16_t temperature;
+    uint16_t humidity;
+};
+
 /**
  * scd4x_start_periodic_measurement() - start periodic measurement, signal
  * update interval is 5 seconds.
@@ -78,6 +96,17 @@ int16_t scd4x_start_periodic_measurement(void);
 int16_t scd4x_read_measurement_ticks(uint16_t* co2, uint16_t* temperature,
                                      uint16_t* humidity);
 
+/**
+ * scd4x_read_measurement_frame() - read sensor output like
+ * @ref scd4x_read_measurement_ticks(), validating the CRCs and decoding the
+ * receive buffer straight into ticks in one pass.
+ *
+ * @param ticks Raw CO₂, temperature and humidity words
+ *
+ * @return 0 on success, an error code otherwise
+ */
+int16_t scd4x_read_measurement_frame(struct scd4x_measurement_ticks* ticks);
+
 /**
  * scd4x_read_measurement() - read sensor output and convert.
  * See @ref scd4x_read_measurement_ticks() for more details.
@@ -97,6 +126,40 @@ int16_t scd4x_read_measurement_ticks(uint16_t* co2, uint16_t* temperature,
 int16_t scd4x_read_measurement(uint16_t* co2, int32_t* temperature_m_deg_c,
                                int32_t* humidity_m_percent_rh);
 
+/**
+ * scd4x_read_measurement_aligned() - read the next sample of a running
+ * periodic measurement without polling the data ready flag for every read.
+ *
+ * The driver learns the measurement phase from the data ready flag and
+ * afterwards reads each sample right after its expected
+ * completion. It falls back to the flag, and learns the phase again, only
+ * when a read is NACKed because the sensor's clock drifted. Without a running
+ * periodic measurement this is @ref scd4x_read_measurement().
+ *
+ * @return 0 on success, -EAGAIN if no new sample is available yet, an error
+ * code otherwise
+ */
+int16_t scd4x_read_measurement_aligned(uint16_t* co2,
+                                       int32_t* temperature_m_deg_c,
+                                       int32_t* humidity_m_percent_rh);
+
+/**
+ * scd4x_ms_until_ready() - time until the next sample of a running periodic
+ * measurement can be read with @ref scd4x_read_measurement_aligned().
+ *
+ * @return milliseconds to wait, 0 if a sample is due or the phase is unknown
+ */
+int32_t scd4x_ms_until_ready(void);
+
+/**
+ * scd4x_ms_until_idle() - time until the sensor has finished executing its
+ * last command, e.g. a stop, a wake-up or a single shot.
+ *
+ * @return milliseconds until the next command is sent without waiting, 0 if
+ * the sensor is idle
+ */
+int32_t scd4x_ms_until_idle(void);
+
 /**
  * scd4x_stop_periodic_measurement() - Stop periodic measurement and return to
  * idle mode for sensor configuration or to safe energy.
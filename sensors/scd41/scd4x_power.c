@@ -0,0 +1,197 @@
+#include "sensirion_i2c_cmd.h"
+#include "scd4x_i2c.h"
+#include "scd4x_power.h"
+#include "sensirion_common.h"
+
+static struct {
+    uint32_t interval_ms;
+    enum scd4x_power_mode mode;
+    bool active; /* mode is running on the sensor */
+    bool powered_down;
+    bool shot_pending;
+    bool discard_shot; /* first shot after a wake-up */
+    int64_t shot_done; /* uptime in ms */
+} scd4x_power;
+
+static enum scd4x_power_mode scd4x_power_cheapest(uint32_t interval_ms) {
+    if (interval_ms >= SCD4X_POWER_SINGLE_SHOT_MIN_MS) {
+        return SCD4X_POWER_SINGLE_SHOT;
+    }
+    if (interval_ms >= SCD4X_POWER_LOW_POWER_MIN_MS) {
+        return SCD4X_POWER_LOW_POWER;
+    }
+    return SCD4X_POWER_PERIODIC;
+}
+
+/*
+ * Steps that send a command yield with -EAGAIN while the sensor still
+ * executes the previous one, and a step ends after a command with a long
+ * execution time, so no caller ever waits for the sensor.
+ */
+static bool scd4x_power_busy(void) {
+    return scd4x_ms_until_idle() > 0;
+}
+
+static int16_t scd4x_power_apply(void) {
+    int16_t error = NO_ERROR;
+
+    if (scd4x_power.active) {
+        return NO_ERROR;
+    }
+    if (scd4x_power_busy()) {
+        return -EAGAIN;
+    }
+    if (scd4x_power.powered_down &&
+        scd4x_power.mode != SCD4X_POWER_SINGLE_SHOT) {
+        scd4x_wake_up();
+        scd4x_power.powered_down = false;
+        return -EAGAIN;
+    }
+
+    switch (scd4x_power.mode) {
+    case SCD4X_POWER_PERIODIC:
+        error = scd4x_start_periodic_measurement();
+        break;
+    case SCD4X_POWER_LOW_POWER:
+        error = scd4x_start_low_power_periodic_measurement();
+        break;
+    default:
+        /* single shots are triggered by the reads */
+        scd4x_power.shot_pending = false;
+        break;
+    }
+    scd4x_power.active = error == NO_ERROR;
+    return error;
+}
+
+int16_t scd4x_power_start(uint32_t interval_ms) {
+    scd4x_power.interval_ms = interval_ms;
+    scd4x_power.mode = scd4x_power_cheapest(interval_ms);
+    scd4x_power.active = false;
+    scd4x_power.powered_down = false;
+    scd4x_power.shot_pending = false;
+    scd4x_power.discard_shot = false;
+    return scd4x_power_apply();
+}
+
+static int16_t scd4x_power_single_shot(uint16_t* co2,
+                                       int32_t* temperature_m_deg_c,
+                                       int32_t* humidity_m_percent_rh) {
+    int16_t error;
+
+    if (!scd4x_power.shot_pending) {
+        if (scd4x_power_busy()) {
+            return -EAGAIN;
+        }
+        if (scd4x_power.powered_down) {
+            scd4x_wake_up();
+            scd4x_power.powered_down = false;
+            scd4x_power.discard_shot = true;
+            return -EAGAIN;
+        }
+        error = scd4x_measure_single_shot();
+        if (error) {
+            return error;
+        }
+        scd4x_power.shot_pending = true;
+        scd4x_power.shot_done =
+            k_uptime_get() + SCD4X_SINGLE_SHOT_MS + SCD4X_PHASE_GUARD_MS;
+        return -EAGAIN;
+    }
+    if (k_uptime_get() < scd4x_power.shot_done || scd4x_power_busy()) {
+        return -EAGAIN;
+    }
+
+    scd4x_power.shot_pending = false;
+    error = scd4x_read_measurement(co2, temperature_m_deg_c,
+                                   humidity_m_percent_rh);
+    if (error) {
+        return error;
+    }
+    if (scd4x_power.discard_shot) {
+        scd4x_power.discard_shot = false;
+        return scd4x_power_single_shot(co2, temperature_m_deg_c,
+                                       humidity_m_percent_rh);
+    }
+    if (scd4x_power.interval_ms >= SCD4X_POWER_DOWN_MIN_MS &&
+        scd4x_power_down() == NO_ERROR) {
+        scd4x_power.powered_down = true;
+    }
+    return NO_ERROR;
+}
+
+int16_t scd4x_power_read(uint16_t* co2, int32_t* temperature_m_deg_c,
+                         int32_t* humidity_m_percent_rh) {
+    int16_t error;
+
+    error = scd4x_power_apply();
+    if (error) {
+        return error;
+    }
+    if (scd4x_power.mode == SCD4X_POWER_SINGLE_SHOT) {
+        return scd4x_power_single_shot(co2, temperature_m_deg_c,
+                                       humidity_m_percent_rh);
+    }
+    if (scd4x_power_busy()) {
+        /* e.g. an ambient pressure written ahead of the read */
+        return -EAGAIN;
+    }
+    return scd4x_read_measurement_aligned(co2, temperature_m_deg_c,
+                                          humidity_m_percent_rh);
+}
+
+int16_t scd4x_power_suspend(void) {
+    int16_t error;
+
+    if (scd4x_power.powered_down) {
+        scd4x_power.active = false;
+        scd4x_power.shot_pending = false;
+        return NO_ERROR;
+    }
+    /* also waits out a running single shot */
+    if (scd4x_power_busy()) {
+        return -EAGAIN;
+    }
+    if (scd4x_power.active && scd4x_power.mode != SCD4X_POWER_SINGLE_SHOT) {
+        error = scd4x_stop_periodic_measurement();
+        if (error) {
+            return error;
+        }
+        scd4x_power.active = false;
+        return -EAGAIN;
+    }
+    scd4x_power.active = false;
+    scd4x_power.shot_pending = false;
+    error = scd4x_power_down();
+    if (error) {
+        return error;
+    }
+    scd4x_power.powered_down = true;
+    return NO_ERROR;
+}
+
+int16_t scd4x_power_resume(void) {
+    return scd4x_power_apply();
+}
+
+int32_t scd4x_power_ms_until_ready(void) {
+    int32_t idle = scd4x_ms_until_idle();
+    int64_t wait;
+
+    if (scd4x_power.mode != SCD4X_POWER_SINGLE_SHOT) {
+        return MAX(scd4x_ms_until_ready(), idle);
+    }
+    if (!scd4x_power.shot_pending) {
+        return idle;
+    }
+    wait = scd4x_power.shot_done - k_uptime_get();
+    return MAX(wait > 0 ? (int32_t)wait : 0, idle);
+}
+
+bool scd4x_power_awake(void) {
+    return !scd4x_power.powered_down;
+}
+
+enum scd4x_power_mode scd4x_power_mode(void) {
+    return scd4x_power.mode;
+}
@@ -0,0 +1,92 @@
+#ifndef SCD4X_POWER_H
+#define SCD4X_POWER_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Sample intervals from which the cheaper modes meet the sample rate. */
+#define SCD4X_POWER_LOW_POWER_MIN_MS 30000
+#define SCD4X_POWER_SINGLE_SHOT_MIN_MS 60000
+/* Sample interval from which the sensor is powered down between single shots.
+ * The first shot after a wake-up is discarded, so shorter intervals are
+ * cheaper in idle. */
+#define SCD4X_POWER_DOWN_MIN_MS 300000
+
+enum scd4x_power_mode {
+    SCD4X_POWER_PERIODIC,
+    SCD4X_POWER_LOW_POWER,
+    SCD4X_POWER_SINGLE_SHOT,
+};
+
+/**
+ * scd4x_power_start() - start measuring in the cheapest mode that meets the
+ * sample interval. The sensor must be idle, e.g. after scd4x_reinit().
+ *
+ * None of the calls below waits for the sensor: while it still executes a
+ * command they return -EAGAIN, and are called again after
+ * scd4x_power_ms_until_ready().
+ *
+ * @param interval_ms Time between two samples taken by the application
+ *
+ * @return 0 on success, -EAGAIN if the sensor is busy, an error code otherwise
+ */
+int16_t scd4x_power_start(uint32_t interval_ms);
+
+/**
+ * scd4x_power_read() - take the next sample in the current mode. Single shots
+ * are triggered by this call and read by a later one, with the sensor powered
+ * down in between if the interval allows it. The mode stays the one chosen
+ * for the interval: the application reads no faster than that, so a faster
+ * mode would only cost power.
+ *
+ * @return 0 on success, -EAGAIN if the sample is not ready yet or the mode is
+ * still being started, an error code otherwise
+ */
+int16_t scd4x_power_read(uint16_t* co2, int32_t* temperature_m_deg_c,
+                         int32_t* humidity_m_percent_rh);
+
+/**
+ * scd4x_power_ms_until_ready() - time until scd4x_power_read() can return the
+ * next sample or make progress, including the time the sensor is busy.
+ *
+ * @return milliseconds to wait, 0 if a sample is due or the time is unknown
+ */
+int32_t scd4x_power_ms_until_ready(void);
+
+/**
+ * scd4x_power_suspend() - stop measuring and power the sensor down until
+ * scd4x_power_resume(). A read in between resumes on its own.
+ *
+ * @return 0 on success, -EAGAIN while the stop is under way, an error code
+ * otherwise
+ */
+int16_t scd4x_power_suspend(void);
+
+/**
+ * scd4x_power_resume() - measure again in the mode that ran before
+ * scd4x_power_suspend().
+ *
+ * @return 0 on success, -EAGAIN while the wake-up is under way, an error code
+ * otherwise
+ */
+int16_t scd4x_power_resume(void);
+
+/**
+ * scd4x_power_awake() - whether the sensor accepts commands, i.e. is not
+ * powered down between single shots or while suspended.
+ */
+bool scd4x_power_awake(void);
+
+/**
+ * scd4x_power_mode() - the mode the controller currently runs.
+ */
+enum scd4x_power_mode scd4x_power_mode(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCD4X_POWER_H */
@@ -0,0 +1,53 @@
+#include <zephyr/sys/atomic.h>
+#include "sensirion_i2c_cmd.h"
+#include "scd4x_i2c.h"
+#include "scd4x_pressure.h"
+#include "sensirion_common.h"
+
+static struct {
+    atomic_t pending;  /* Pa, 0 if unknown */
+    uint32_t applied;  /* Pa, 0 if not written since the start */
+    uint32_t step_pa;
+} scd4x_pressure;
+
+int16_t scd4x_pressure_start(uint16_t altitude_m, uint32_t step_pa) {
+    scd4x_pressure.step_pa = step_pa;
+    scd4x_pressure.applied = 0;
+    return scd4x_set_sensor_altitude(altitude_m);
+}
+
+int scd4x_pressure_set(uint32_t pressure_pa) {
+    if (pressure_pa < SCD4X_PRESSURE_MIN_PA ||
+        pressure_pa > SCD4X_PRESSURE_MAX_PA) {
+        return -EINVAL;
+    }
+    atomic_set(&scd4x_pressure.pending, pressure_pa);
+    return 0;
+}
+
+int16_t scd4x_pressure_update(void) {
+    uint32_t pressure = atomic_get(&scd4x_pressure.pending);
+    uint32_t applied = scd4x_pressure.applied;
+    uint32_t delta = pressure > applied ? pressure - applied
+                                        : applied - pressure;
+    int16_t error;
+
+    if (pressure == 0 || (applied != 0 && delta < scd4x_pressure.step_pa)) {
+        return NO_ERROR;
+    }
+    /* rather than wait for the sensor, a later update writes it */
+    if (scd4x_ms_until_idle() > 0) {
+        return NO_ERROR;
+    }
+    /* the sensor takes whole hPa */
+    error = scd4x_set_ambient_pressure((pressure + 50) / 100);
+    if (error) {
+        return error;
+    }
+    scd4x_pressure.applied = pressure;
+    return NO_ERROR;
+}
+
+uint32_t scd4x_pressure_applied(void) {
+    return scd4x_pressure.applied;
+}
@@ -0,0 +1,57 @@
+#ifndef SCD4X_PRESSURE_H
+#define SCD4X_PRESSURE_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Ambient pressure range the SCD4x compensates for. */
+#define SCD4X_PRESSURE_MIN_PA 70000
+#define SCD4X_PRESSURE_MAX_PA 120000
+
+/**
+ * scd4x_pressure_start() - write the sensor altitude, which compensates the
+ * readings until an ambient pressure is known, and make the next
+ * scd4x_pressure_update() write the last known pressure again. The sensor
+ * must be idle, e.g. after scd4x_reinit().
+ *
+ * @param altitude_m Sensor altitude above sea level
+ * @param step_pa    Smallest pressure change that is written to the sensor
+ *
+ * @return 0 on success, an error code otherwise
+ */
+int16_t scd4x_pressure_start(uint16_t altitude_m, uint32_t step_pa);
+
+/**
+ * scd4x_pressure_set() - hand in a new ambient pressure, e.g. from a
+ * barometer or pushed over the network. Does not access the sensor, so it
+ * may be called from any thread.
+ *
+ * @return 0 on success, -EINVAL if the pressure is out of range
+ */
+int scd4x_pressure_set(uint32_t pressure_pa);
+
+/**
+ * scd4x_pressure_update() - write the ambient pressure to the sensor if it
+ * moved by at least the step since the last write. Works in idle mode and
+ * during measurements; a written pressure overrides the altitude. While the
+ * sensor still executes a command the write is left to a later call.
+ *
+ * @return 0 on success, an error code otherwise
+ */
+int16_t scd4x_pressure_update(void);
+
+/**
+ * scd4x_pressure_applied() - the pressure the readings are compensated for.
+ *
+ * @return pressure in Pa, 0 while the altitude is used
+ */
+uint32_t scd4x_pressure_applied(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCD4X_PRESSURE_H */
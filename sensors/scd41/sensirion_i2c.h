@@ -57,6 +57,97 @@ uint8_t sensirion_i2c_generate_crc(const uint8_t* data, uint16_t count);
 int8_t sensirion_i2c_check_crc(const uint8_t* data, uint16_t count,
                                uint8_t checksum);
 
+/**
+ * sensirion_i2c_check_crc_words() - check a received stream of data words,
+ * each followed by its CRC byte, in one pass
+ *
+ * @buf:         Received bytes, num_words * (SENSIRION_WORD_SIZE + CRC8_LEN)
+ *               long
+ * @num_words:   Number of data words in buf
+ * @failed_word: Set to the index of the first word with a wrong CRC. May be
+ *               NULL.
+ *
+ * @return      NO_ERROR if all checksums match, CRC_ERROR otherwise
+ */
+int16_t sensirion_i2c_check_crc_words(const uint8_t* buf, uint16_t num_words,
+                                      uint16_t* failed_word);
+
+/**
+ * sensirion_i2c_report_crc_error() - report a frame that failed its CRC check
+ *
+ * Locates the first word with a wrong CRC with
+ * sensirion_i2c_check_crc_words() and passes it to the HAL. Only the error
+ * path pays for the second pass.
+ *
+ * @address:   Sensor i2c address
+ * @frame:     Received bytes, still as received
+ * @num_words: Number of data words in frame
+ */
+void sensirion_i2c_report_crc_error(uint8_t address, const uint8_t* frame,
+                                    uint16_t num_words);
+
+/**
+ * sensirion_i2c_strip_crcs() - move the data words of a frame whose CRCs
+ * were checked to its start, dropping the CRC bytes
+ *
+ * @frame:     Received bytes, num_words * SENSIRION_WORD_SIZE long afterwards
+ * @num_words: Number of data words in frame
+ */
+void sensirion_i2c_strip_crcs(uint8_t* frame, uint16_t num_words);
+
+/**
+ * sensirion_i2c_decode_bytes() - check and strip the CRCs of a received frame
+ *
+ * Validates each word's CRC and copies its two bytes (MSB first) to data in
+ * the same pass. data may alias frame.
+ *
+ * @frame:      Received bytes, num_words * (SENSIRION_WORD_SIZE + CRC8_LEN)
+ *              long
+ * @num_words:  Number of data words in frame
+ * @data:       Output, num_words * SENSIRION_WORD_SIZE bytes. May have been
+ *              partially written in case of an error.
+ *
+ * @return      NO_ERROR on success, CRC_ERROR otherwise
+ */
+int16_t sensirion_i2c_decode_bytes(const uint8_t* frame, uint16_t num_words,
+                                   uint8_t* data);
+
+/**
+ * sensirion_i2c_decode_uint16() - check the CRCs of a received frame and
+ *                                 decode it into host-order words in one pass
+ *
+ * @frame:      Received bytes, num_words * (SENSIRION_WORD_SIZE + CRC8_LEN)
+ *              long
+ * @num_words:  Number of data words in frame
+ * @values:     Output, num_words values
+ *
+ * @return      NO_ERROR on success, CRC_ERROR otherwise
+ */
+int16_t sensirion_i2c_decode_uint16(const uint8_t* frame, uint16_t num_words,
+                                    uint16_t* values);
+
+/**
+ * sensirion_i2c_decode_uint32() - check the CRCs of a received frame and
+ *                                 decode word pairs into host-order 32-bit
+ *                                 values in one pass
+ *
+ * @frame:      Received bytes, num_values * 2 * (SENSIRION_WORD_SIZE +
+ *              CRC8_LEN) long
+ * @num_values: Number of 32-bit values in frame
+ * @values:     Output, num_values values
+ *
+ * @return      NO_ERROR on success, CRC_ERROR otherwise
+ */
+int16_t sensirion_i2c_decode_uint32(const uint8_t* frame, uint16_t num_values,
+                                    uint32_t* values);
+
+/**
+ * sensirion_i2c_decode_float() - like sensirion_i2c_decode_uint32() for
+ *                                IEEE-754 float values
+ */
+int16_t sensirion_i2c_decode_float(const uint8_t* frame, uint16_t num_values,
+                                   float* values);
+
 /**
  * sensirion_i2c_general_call_reset() - Send a general call reset.
  *
@@ -139,33 +230,6 @@ int16_t sensirion_i2c_write_cmd_with_args(uint8_t address, uint16_t command,
                                           const uint16_t* data_words,
                                           uint16_t num_words);
 
-/**
- * sensirion_i2c_delayed_read_cmd() - send a command, wait for the sensor to
- *                                    process and read data back
- * @address:    Sensor i2c address
- * @cmd:        Command
- * @delay:      Time in microseconds to delay sending the read request
- * @data_words: Allocated buffer to store the read data
- * @num_words:  Data words to read (without CRC bytes)
- *
- * @return      NO_ERROR on success, an error code otherwise
- */
-int16_t sensirion_i2c_delayed_read_cmd(uint8_t address, uint16_t cmd,
-                                       uint32_t delay_us, uint16_t* data_words,
-                                       uint16_t num_words);
-/**
- * sensirion_i2c_read_cmd() - reads data words from the sensor after a command
- *                            is issued
- * @address:    Sensor i2c address
- * @cmd:        Command
- * @data_words: Allocated buffer to store the read data
- * @num_words:  Data words to read (without CRC bytes)
- *
- * @return      NO_ERROR on success, an error code otherwise
- */
-int16_t sensirion_i2c_read_cmd(uint8_t address, uint16_t cmd,
-                               uint16_t* data_words, uint16_t num_words);
-
 /**
  * sensirion_i2c_add_command_to_buffer() - Add a command to the buffer at
  *                                         offset. Adds 2 bytes to the buffer.
@@ -0,0 +1,265 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "sensirion_common.h"
+#include "sensirion_config.h"
+#include "sensirion_i2c.h"
+#include "sensirion_i2c_cmd.h"
+#include "sensirion_i2c_hal.h"
+#include "../i2c/i2c_bus.h"
+#include "../i2c/i2c_engine.h"
+
+struct sensirion_i2c_deadline {
+    uint8_t bus_idx;
+    uint8_t address;
+    int64_t busy_until;
+};
+
+static struct sensirion_i2c_deadline deadlines[SENSIRION_I2C_CMD_MAX_DEVICES];
+static struct k_spinlock deadlines_lock;
+
+static struct sensirion_i2c_deadline* find_deadline(uint8_t bus_idx,
+                                                    uint8_t address) {
+    struct sensirion_i2c_deadline* free_slot = NULL;
+    uint8_t i;
+
+    for (i = 0; i < SENSIRION_I2C_CMD_MAX_DEVICES; i++) {
+        if (deadlines[i].address == address &&
+            deadlines[i].bus_idx == bus_idx) {
+            return &deadlines[i];
+        }
+        if (deadlines[i].address == 0 && free_slot == NULL) {
+            free_slot = &deadlines[i];
+        }
+    }
+    if (free_slot) {
+        free_slot->bus_idx = bus_idx;
+        free_slot->address = address;
+        free_slot->busy_until = 0;
+    }
+    return free_slot;
+}
+
+/*
+ * Ticks until the sensor has finished its previous command, or -ENOMEM if
+ * the sensor has no deadline slot and none is free. Claims the slot, so a
+ * later set_busy() for the sensor always finds it.
+ */
+static int64_t ticks_until_idle(uint8_t bus_idx, uint8_t address) {
+    k_spinlock_key_t key = k_spin_lock(&deadlines_lock);
+    struct sensirion_i2c_deadline* d = find_deadline(bus_idx, address);
+    int64_t wait = d ? MAX(d->busy_until - k_uptime_ticks(), 0) : -ENOMEM;
+
+    k_spin_unlock(&deadlines_lock, key);
+    return wait;
+}
+
+int32_t sensirion_i2c_cmd_ms_until_idle(uint8_t address) {
+    struct i2c_bus* bus = i2c_bus_selected();
+    k_spinlock_key_t key;
+    int64_t wait = 0;
+    uint8_t i;
+
+    if (bus == NULL) {
+        return 0;
+    }
+    key = k_spin_lock(&deadlines_lock);
+    for (i = 0; i < SENSIRION_I2C_CMD_MAX_DEVICES; i++) {
+        if (deadlines[i].address == address &&
+            deadlines[i].bus_idx == bus->idx) {
+            wait = MAX(deadlines[i].busy_until - k_uptime_ticks(), 0);
+            break;
+        }
+    }
+    k_spin_unlock(&deadlines_lock, key);
+    return (int32_t)k_ticks_to_ms_ceil64(wait);
+}
+
+static void set_busy(uint8_t bus_idx, uint8_t address, uint32_t exec_us) {
+    k_spinlock_key_t key = k_spin_lock(&deadlines_lock);
+    struct sensirion_i2c_deadline* d = find_deadline(bus_idx, address);
+
+    __ASSERT(d != NULL, "no deadline slot for %u:0x%02x", bus_idx, address);
+    if (d) {
+        d->busy_until = k_uptime_ticks() + k_us_to_ticks_ceil64(exec_us);
+    }
+    k_spin_unlock(&deadlines_lock, key);
+}
+
+static void cmd_finish(struct sensirion_i2c_cmd* cmd, int16_t error) {
+    uint16_t bad_word;
+
+    if (error == NO_ERROR && cmd->rx_words && !cmd->raw_frame) {
+        /* checked before the data is compacted in place, which overwrites
+         * the frame, so that a bad word can still be located */
+        error = sensirion_i2c_check_crc_words(cmd->rx_buf, cmd->rx_words,
+                                              &bad_word);
+        if (error == CRC_ERROR) {
+            sensirion_i2c_hal_report_crc_error(cmd->address, bad_word);
+        } else {
+            sensirion_i2c_strip_crcs(cmd->rx_buf, cmd->rx_words);
+        }
+    }
+    cmd->cb(cmd, error);
+}
+
+static void cmd_submit_txn(struct sensirion_i2c_cmd* cmd) {
+    if (i2c_engine_submit(&cmd->txn) < 0) {
+        cmd->cb(cmd, I2C_BUS_ERROR);
+    }
+}
+
+static void cmd_start_read(struct k_timer* timer) {
+    struct sensirion_i2c_cmd* cmd = k_timer_user_data_get(timer);
+
+    cmd->reading = true;
+    cmd->msg.buf = cmd->rx_buf;
+    cmd->msg.len = cmd->rx_words * (SENSIRION_WORD_SIZE + CRC8_LEN);
+    cmd->msg.flags = I2C_MSG_READ | I2C_MSG_STOP;
+    cmd_submit_txn(cmd);
+}
+
+static void cmd_txn_done(struct i2c_txn* txn, int result) {
+    struct sensirion_i2c_cmd* cmd =
+        CONTAINER_OF(txn, struct sensirion_i2c_cmd, txn);
+
+    if (cmd->reading) {
+        cmd_finish(cmd, result);
+        return;
+    }
+
+    /* Sensors such as the SCD4x do not acknowledge a wake-up, so the sensor
+     * is treated as busy even when the write failed. */
+    set_busy(cmd->txn.bus->idx, cmd->address, cmd->exec_us);
+
+    if (result < 0 || cmd->rx_words == 0) {
+        /* failed or write-only */
+        cmd_finish(cmd, result);
+        return;
+    }
+
+    k_timer_init(&cmd->timer, cmd_start_read, NULL);
+    k_timer_user_data_set(&cmd->timer, cmd);
+    if (cmd->exec_us == 0) {
+        cmd_start_read(&cmd->timer);
+        return;
+    }
+    k_timer_start(&cmd->timer, K_USEC(cmd->exec_us), K_NO_WAIT);
+}
+
+static void cmd_start_write(struct k_timer* timer) {
+    struct sensirion_i2c_cmd* cmd = k_timer_user_data_get(timer);
+
+    cmd->msg.buf = (uint8_t*)cmd->tx_buf;
+    cmd->msg.len = cmd->tx_len;
+    cmd->msg.flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+    cmd_submit_txn(cmd);
+}
+
+int16_t sensirion_i2c_cmd_submit(struct sensirion_i2c_cmd* cmd) {
+    int64_t wait;
+
+    if (cmd->cb == NULL || cmd->tx_buf == NULL || cmd->tx_len == 0 ||
+        (cmd->rx_words && cmd->rx_buf == NULL)) {
+        return BYTE_NUM_ERROR;
+    }
+
+    cmd->txn.bus = i2c_bus_selected();
+    if (cmd->txn.bus == NULL) {
+        return I2C_BUS_ERROR;
+    }
+
+    /* Without a slot the sensor's execution time could not be honoured. */
+    wait = ticks_until_idle(cmd->txn.bus->idx, cmd->address);
+    if (wait < 0) {
+        return (int16_t)wait;
+    }
+
+    cmd->txn.addr = cmd->address;
+    cmd->txn.msgs = &cmd->msg;
+    cmd->txn.num_msgs = 1;
+    cmd->txn.cb = cmd_txn_done;
+    cmd->reading = false;
+
+    k_timer_init(&cmd->timer, cmd_start_write, NULL);
+    k_timer_user_data_set(&cmd->timer, cmd);
+
+    if (wait > 0) {
+        k_timer_start(&cmd->timer, K_TICKS(wait), K_NO_WAIT);
+    } else {
+        cmd_start_write(&cmd->timer);
+    }
+    return NO_ERROR;
+}
+
+struct cmd_sync_ctx {
+    struct k_sem done;
+    int16_t error;
+};
+
+static void cmd_sync_cb(struct sensirion_i2c_cmd* cmd, int16_t error) {
+    struct cmd_sync_ctx* ctx = cmd->user_data;
+
+    ctx->error = error;
+    k_sem_give(&ctx->done);
+}
+
+static int16_t cmd_exec(uint8_t address, const uint8_t* tx_buf,
+                        uint16_t tx_len, uint32_t exec_us, uint8_t* rx_buf,
+                        uint16_t rx_words, bool raw_frame) {
+    struct cmd_sync_ctx ctx;
+    struct sensirion_i2c_cmd cmd = {
+        .address = address,
+        .tx_buf = tx_buf,
+        .tx_len = tx_len,
+        .exec_us = exec_us,
+        .rx_buf = rx_buf,
+        .rx_words = rx_words,
+        .raw_frame = raw_frame,
+        .cb = cmd_sync_cb,
+        .user_data = &ctx,
+    };
+    int16_t error;
+
+    k_sem_init(&ctx.done, 0, 1);
+    error = sensirion_i2c_cmd_submit(&cmd);
+    if (error) {
+        return error;
+    }
+    k_sem_take(&ctx.done, K_FOREVER);
+    return ctx.error;
+}
+
+int16_t sensirion_i2c_cmd_exec(uint8_t address, const uint8_t* tx_buf,
+                               uint16_t tx_len, uint32_t exec_us,
+                               uint8_t* rx_buf, uint16_t rx_words) {
+    return cmd_exec(address, tx_buf, tx_len, exec_us, rx_buf, rx_words, false);
+}
+
+int16_t sensirion_i2c_cmd_exec_frame(uint8_t address, const uint8_t* tx_buf,
+                                     uint16_t tx_len, uint32_t exec_us,
+                                     uint8_t* frame, uint16_t rx_words) {
+    return cmd_exec(address, tx_buf, tx_len, exec_us, frame, rx_words, true);
+}
+
+int16_t sensirion_i2c_cmd_run(uint8_t address,
+                              const struct sensirion_i2c_cmd_desc* desc,
+                              const uint16_t* args, uint8_t* rx_buf) {
+    uint8_t tx[SENSIRION_I2C_CMD_MAX_FRAME +
+               SENSIRION_I2C_CMD_MAX_ARGS * (SENSIRION_WORD_SIZE + CRC8_LEN)];
+    uint16_t len = desc->frame_len;
+    uint8_t i;
+
+    if (desc->arg_words > SENSIRION_I2C_CMD_MAX_ARGS ||
+        (desc->arg_words && args == NULL)) {
+        return BYTE_NUM_ERROR;
+    }
+
+    memcpy(tx, desc->frame, desc->frame_len);
+    for (i = 0; i < desc->arg_words; i++) {
+        len = sensirion_i2c_add_uint16_t_to_buffer(tx, len, args[i]);
+    }
+    return cmd_exec(address, tx, len, desc->exec_us, rx_buf, desc->rx_words,
+                    desc->raw_frame);
+}
@@ -0,0 +1,188 @@
+#ifndef SENSIRION_I2C_CMD_H
+#define SENSIRION_I2C_CMD_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/i2c.h>
+
+#include "sensirion_config.h"
+#include "sensirion_i2c.h"
+#include "../i2c/i2c_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of sensors (bus and address) whose busy deadline is tracked.
+ * Commands to further sensors fail with -ENOMEM. */
+#define SENSIRION_I2C_CMD_MAX_DEVICES 4
+/* Fixed part of a command frame: the opcode and at most one argument word. */
+#define SENSIRION_I2C_CMD_MAX_FRAME \
+    (SENSIRION_COMMAND_SIZE + SENSIRION_WORD_SIZE + CRC8_LEN)
+/* Argument words a command takes at runtime. */
+#define SENSIRION_I2C_CMD_MAX_ARGS 2
+
+/**
+ * Compile-time description of a sensor command. Drivers keep these in const
+ * tables, so the frame of a command is never rebuilt at runtime and its cost,
+ * exec_us plus the words on the bus, is known up front.
+ */
+struct sensirion_i2c_cmd_desc {
+    uint8_t frame[SENSIRION_I2C_CMD_MAX_FRAME]; /* opcode, fixed args, CRCs */
+    uint8_t frame_len;
+    uint8_t arg_words; /* appended to the frame at runtime */
+    uint8_t rx_words;
+    bool raw_frame; /* leave the response as received, CRCs unchecked */
+    uint32_t exec_us;
+};
+
+#define SENSIRION_I2C_CMD_OPCODE(opcode) (uint8_t)((opcode) >> 8), \
+                                         (uint8_t)((opcode) & 0xFF)
+
+/** A command taking arg_words arguments and returning rx_words words. */
+#define SENSIRION_I2C_CMD_DESC(opcode, args, rx, us)                         \
+    {                                                                        \
+        .frame = {SENSIRION_I2C_CMD_OPCODE(opcode)},                         \
+        .frame_len = SENSIRION_COMMAND_SIZE, .arg_words = (args),            \
+        .rx_words = (rx), .exec_us = (us),                                   \
+    }
+
+/** A command with a constant argument word; crc is the word's CRC-8. */
+#define SENSIRION_I2C_CMD_DESC_FIXED(opcode, arg, crc, rx, us)               \
+    {                                                                        \
+        .frame = {SENSIRION_I2C_CMD_OPCODE(opcode),                          \
+                  SENSIRION_I2C_CMD_OPCODE(arg), (crc)},                     \
+        .frame_len = SENSIRION_I2C_CMD_MAX_FRAME, .rx_words = (rx),          \
+        .exec_us = (us),                                                     \
+    }
+
+/** A command whose response frame is decoded by the caller. */
+#define SENSIRION_I2C_CMD_DESC_FRAME(opcode, rx, us)                         \
+    {                                                                        \
+        .frame = {SENSIRION_I2C_CMD_OPCODE(opcode)},                         \
+        .frame_len = SENSIRION_COMMAND_SIZE, .rx_words = (rx),               \
+        .raw_frame = true, .exec_us = (us),                                  \
+    }
+
+struct sensirion_i2c_cmd;
+
+/**
+ * Completion callback of an asynchronous command. Runs on the bus's engine
+ * thread and must not block.
+ *
+ * @param cmd   The completed command; response words are in cmd->rx_buf
+ * @param error NO_ERROR, CRC_ERROR or a negative errno from the bus
+ */
+typedef void (*sensirion_i2c_cmd_cb_t)(struct sensirion_i2c_cmd* cmd,
+                                       int16_t error);
+
+/**
+ * An I2C command to a Sensirion sensor: a write of tx_buf, the command's
+ * execution time, then optionally a read of rx_words data words.
+ *
+ * The command goes to the bus selected with sensirion_i2c_hal_select_bus().
+ * The layer remembers, per bus and address, until when the sensor is busy
+ * executing the last command. A command is only written once that deadline
+ * has passed, and its response is read as soon as its own execution time has
+ * elapsed, right after the write if it has none. Write and read are separate
+ * transfers, each ended by a stop, as the Sensirion sensors expect. Both
+ * waits are timer driven, so sensirion_i2c_cmd_submit() returns at once;
+ * the synchronous helpers below block their caller until completion.
+ */
+struct sensirion_i2c_cmd {
+    /* set by the caller */
+    uint8_t address;
+    const uint8_t* tx_buf;
+    uint16_t tx_len;
+    uint32_t exec_us;
+    uint8_t* rx_buf; /* rx_words * 3 bytes; data is compacted in place */
+    uint16_t rx_words;
+    bool raw_frame; /* leave rx_buf as received, CRCs unchecked */
+    sensirion_i2c_cmd_cb_t cb;
+    void* user_data;
+
+    /* private */
+    struct i2c_txn txn;
+    struct i2c_msg msg;
+    struct k_timer timer;
+    bool reading;
+};
+
+/**
+ * sensirion_i2c_cmd_submit() - start an asynchronous command and return
+ *
+ * The command structure and its buffers must stay valid until the callback
+ * has run.
+ *
+ * @return NO_ERROR if the command was queued, -ENOMEM if
+ *         SENSIRION_I2C_CMD_MAX_DEVICES other sensors are already tracked,
+ *         another error code otherwise
+ */
+int16_t sensirion_i2c_cmd_submit(struct sensirion_i2c_cmd* cmd);
+
+/**
+ * sensirion_i2c_cmd_ms_until_idle() - time until a sensor has finished its
+ * last command
+ *
+ * A write-only command's execution time is charged to the next command to
+ * the same sensor. Command sequences ask this first and yield while it is
+ * not 0, so that no thread waits out a long execution time.
+ *
+ * @address: Sensor i2c address on the selected bus
+ *
+ * @return   milliseconds until the next command is written without waiting,
+ *           0 if the sensor is idle or was never sent a command
+ */
+int32_t sensirion_i2c_cmd_ms_until_idle(uint8_t address);
+
+/**
+ * sensirion_i2c_cmd_exec() - execute a command and wait for its completion
+ *
+ * Synchronous: the calling thread blocks on a semaphore until the command
+ * completed, including the rest of the previous command's execution time and,
+ * for commands that return data, their own. Write-only commands return as
+ * soon as the command is written; their execution time delays the next
+ * command to the same sensor instead of the caller.
+ *
+ * @address:  Sensor i2c address
+ * @tx_buf:   Command frame to write
+ * @tx_len:   Length of the command frame
+ * @exec_us:  Execution time of the command in microseconds
+ * @rx_buf:   Buffer for rx_words words plus CRCs, may be NULL if rx_words is 0
+ * @rx_words: Number of response words to read
+ *
+ * @return    NO_ERROR on success, an error code otherwise
+ */
+int16_t sensirion_i2c_cmd_exec(uint8_t address, const uint8_t* tx_buf,
+                               uint16_t tx_len, uint32_t exec_us,
+                               uint8_t* rx_buf, uint16_t rx_words);
+
+/**
+ * sensirion_i2c_cmd_exec_frame() - like sensirion_i2c_cmd_exec(), but leave
+ * the response frame as received so the caller can validate and decode it in
+ * one pass with a sensirion_i2c_decode_*() function
+ */
+int16_t sensirion_i2c_cmd_exec_frame(uint8_t address, const uint8_t* tx_buf,
+                                     uint16_t tx_len, uint32_t exec_us,
+                                     uint8_t* frame, uint16_t rx_words);
+
+/**
+ * sensirion_i2c_cmd_run() - execute a described command and wait for its
+ * completion, as sensirion_i2c_cmd_exec() does
+ *
+ * @address: Sensor i2c address
+ * @desc:    The command
+ * @args:    desc->arg_words argument words, may be NULL if there are none
+ * @rx_buf:  Buffer for desc->rx_words words plus CRCs, may be NULL if the
+ *           command returns nothing
+ *
+ * @return   NO_ERROR on success, an error code otherwise
+ */
+int16_t sensirion_i2c_cmd_run(uint8_t address,
+                              const struct sensirion_i2c_cmd_desc* desc,
+                              const uint16_t* args, uint8_t* rx_buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSIRION_I2C_CMD_H */
@@ -29,39 +29,30 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <zephyr/device.h>
-#include <zephyr/drivers/i2c.h>
 #include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
 
 #include "sensirion_common.h"
 #include "sensirion_config.h"
 #include "sensirion_i2c_hal.h"
+#include "../i2c/i2c_bus.h"
+#include "../i2c/i2c_engine.h"
+#include "../i2c/i2c_stats.h"
 
-/* I2C device. */
-#define I2C_NODE DT_NODELABEL(i2c0)
 int STATUS_FAIL = 0;
 int STATUS_OK = 1;
-static const struct device* i2c_dev = DEVICE_DT_GET(I2C_NODE);
 
 /**
  * Select the current i2c bus by index.
- * All following i2c operations will be directed at that bus.
+ * All following i2c operations are directed at that bus, so sensors sharing
+ * an address on different buses are addressed by selecting their bus first.
  *
  * @param bus_idx   Bus index to select
  * @returns         0 on success, an error code otherwise
  */
 int16_t sensirion_i2c_hal_select_bus(uint8_t bus_idx) {
-    char bus_name[6] = "I2C_0";
-
-    if (bus_idx > 9) {
-        /* Invalid bus index */
-        return STATUS_FAIL;
-    }
-
-    bus_name[4] = bus_idx + '0';
-    i2c_dev = device_get_binding(bus_name);
-    if (i2c_dev == NULL) {
-        /* No valid device found */
+    if (i2c_bus_select(bus_idx) != 0) {
+        /* No valid bus found */
         return STATUS_FAIL;
     }
 
@@ -73,15 +64,14 @@ int16_t sensirion_i2c_hal_select_bus(uint8_t bus_idx) {
  * communication.
  */
 void sensirion_i2c_hal_init(void) {
-    /* Device (specified by sps30_i2c_dev) is already initialized by the Zephyr
-     * boot-up process. Nothing to be done here. */
+    /* Buses are owned by the bus manager and set up during boot. Nothing to be
+     * done here. */
 }
 
 /**
  * Release all resources initialized by sensirion_i2c_hal_init().
  */
 void sensirion_i2c_hal_free(void) {
-    i2c_dev = NULL;
 }
 
 /**
@@ -95,7 +85,7 @@ void sensirion_i2c_hal_free(void) {
  * @returns 0 on success, error code otherwise
  */
 int8_t sensirion_i2c_hal_read(uint8_t address, uint8_t* data, uint16_t count) {
-    return i2c_read(i2c_dev, data, count, address);
+    return i2c_engine_read(i2c_bus_selected(), address, data, count);
 }
 
 /**
@@ -111,20 +101,21 @@ int8_t sensirion_i2c_hal_read(uint8_t address, uint8_t* data, uint16_t count) {
  */
 int8_t sensirion_i2c_hal_write(uint8_t address, const uint8_t* data,
                                uint16_t count) {
-    return i2c_write(i2c_dev, data, count, address);
+    return i2c_engine_write(i2c_bus_selected(), address, data, count);
 }
 
 /**
- * Sleep for a given number of microseconds. The function should delay the
- * execution for at least the given time, but may also sleep longer.
- *
- * Despite the unit, a <10 millisecond precision is sufficient.
+ * Report that data received from a device on the selected bus failed its
+ * checksum.
  *
- * @param useconds the sleep time in microseconds
+ * @param address 7-bit I2C address of the device
+ * @param word    index of the first data word with a wrong checksum
  */
-void sensirion_i2c_hal_sleep_usec(uint32_t useconds) {
-    int32_t remaining = useconds;
-    while (remaining > 0) {
-        remaining = k_usleep(remaining);
+void sensirion_i2c_hal_report_crc_error(uint8_t address, uint16_t word) {
+    struct i2c_bus* bus = i2c_bus_selected();
+
+    printk("I2C device 0x%02x: CRC error in word %u\n", address, word);
+    if (bus) {
+        i2c_stats_record_crc_error(bus->idx, address);
     }
 }
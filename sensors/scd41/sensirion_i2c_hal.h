@@ -88,22 +88,13 @@ int8_t sensirion_i2c_hal_write(uint8_t address, const uint8_t* data,
                                uint16_t count);
 
 /**
- * Sleep for a given number of microseconds. The function should delay the
- * execution approximately, but no less than, the given time.
+ * Report that data received from a device failed its checksum. Used for bus
+ * telemetry only; the caller still handles the error.
  *
- * When using hardware i2c:
- * Despite the unit, a <10 millisecond precision is sufficient.
- *
- * When using software i2c:
- * The precision needed depends on the desired i2c frequency, i.e. should be
- * exact to about half a clock cycle (defined in
- * `SENSIRION_I2C_CLOCK_PERIOD_USEC` in `sensirion_sw_i2c_gpio.h`).
- *
- * Example with 400kHz requires a precision of 1 / (2 * 400kHz) == 1.25usec.
- *
- * @param useconds the sleep time in microseconds
+ * @param address 7-bit I2C address of the device
+ * @param word    index of the first data word with a wrong checksum
  */
-void sensirion_i2c_hal_sleep_usec(uint32_t useconds);
+void sensirion_i2c_hal_report_crc_error(uint8_t address, uint16_t word);
 
 #ifdef __cplusplus
 }
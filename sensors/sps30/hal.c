@@ -29,17 +29,15 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <zephyr/device.h>
-#include <zephyr/drivers/i2c.h>
-#include <zephyr/kernel.h>
-
 #include "sensirion_arch_config.h"
 #include "../scd41/sensirion_common.h"
-// #include "sensirion_i2c.h"
+#include "../scd41/sensirion_i2c_hal.h"
+
+/*
+ * The SPS30 shares the bus manager and HAL of the SCD4x driver; these entry
+ * points only keep the SPS30 HAL names available.
+ */
 
-/* I2C device. */
-#define I2C_NODE DT_NODELABEL(i2c0)
-static const struct device *i2c_dev = DEVICE_DT_GET(I2C_NODE);
 /**
  * Select the current i2c bus by index.
  * All following i2c operations will be directed at that bus.
@@ -49,23 +47,7 @@ static const struct device *i2c_dev = DEVICE_DT_GET(I2C_NODE);
  */
 int16_t sensirion_i2c_select_bus(uint8_t bus_idx)
 {
-    char bus_name[6] = "I2C_0";
-
-    if (bus_idx > 9)
-    {
-        /* Invalid bus index */
-        return 0;
-    }
-
-    bus_name[4] = bus_idx + '0';
-    i2c_dev = device_get_binding(bus_name);
-    if (i2c_dev == NULL)
-    {
-        /* No valid device found */
-        return 0;
-    }
-
-    return 1;
+    return sensirion_i2c_hal_select_bus(bus_idx);
 }
 
 /**
@@ -74,8 +56,7 @@ int16_t sensirion_i2c_select_bus(uint8_t bus_idx)
  */
 void sensirion_i2c_init(void)
 {
-    /* Device (specified by sps30_i2c_dev) is already initialized by the Zephyr
-     * boot-up process. Nothing to be done here. */
+    sensirion_i2c_hal_init();
 }
 
 /**
@@ -83,7 +64,7 @@ void sensirion_i2c_init(void)
  */
 void sensirion_i2c_release(void)
 {
-    i2c_dev = NULL;
+    sensirion_i2c_hal_free();
 }
 
 /**
@@ -98,7 +79,7 @@ void sensirion_i2c_release(void)
  */
 int8_t sensirion_i2c_read(uint8_t address, uint8_t *data, uint16_t count)
 {
-    return i2c_read(i2c_dev, data, count, address);
+    return sensirion_i2c_hal_read(address, data, count);
 }
 
 /**
@@ -115,22 +96,5 @@ int8_t sensirion_i2c_read(uint8_t address, uint8_t *data, uint16_t count)
 int8_t sensirion_i2c_write(uint8_t address, const uint8_t *data,
                            uint16_t count)
 {
-    return i2c_write(i2c_dev, data, count, address);
+    return sensirion_i2c_hal_write(address, data, count);
 }
-
-/**
- * Sleep for a given number of microseconds. The function should delay the
- * execution for at least the given time, but may also sleep longer.
- *
- * Despite the unit, a <10 millisecond precision is sufficient.
- *
- * @param useconds the sleep time in microseconds
- */
-void sensirion_sleep_usec(uint32_t useconds)
-{
-    int32_t remaining = useconds;
-    while (remaining > 0)
-    {
-        remaining = k_usleep(remaining);
-    }
-}
\ No newline at end of file
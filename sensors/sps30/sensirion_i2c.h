@@ -29,8 +29,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef SENSIRION_I2C_H
-#define SENSIRION_I2C_H
+#ifndef SPS30_SENSIRION_I2C_H
+#define SPS30_SENSIRION_I2C_H
 
 #include "sensirion_arch_config.h"
 
@@ -87,26 +87,8 @@ int8_t sensirion_i2c_read(uint8_t address, uint8_t* data, uint16_t count);
 int8_t sensirion_i2c_write(uint8_t address, const uint8_t* data,
                            uint16_t count);
 
-/**
- * Sleep for a given number of microseconds. The function should delay the
- * execution approximately, but no less than, the given time.
- *
- * When using hardware i2c:
- * Despite the unit, a <10 millisecond precision is sufficient.
- *
- * When using software i2c:
- * The precision needed depends on the desired i2c frequency, i.e. should be
- * exact to about half a clock cycle (defined in
- * `SENSIRION_I2C_CLOCK_PERIOD_USEC` in `sensirion_arch_config.h`).
- *
- * Example with 400kHz requires a precision of 1 / (2 * 400kHz) == 1.25usec.
- *
- * @param useconds the sleep time in microseconds
- */
-void sensirion_sleep_usec(uint32_t useconds);
-
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
 
-#endif /* SENSIRION_I2C_H */
\ No newline at end of file
+#endif /* SPS30_SENSIRION_I2C_H */
\ No newline at end of file
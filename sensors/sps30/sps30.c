@@ -29,37 +29,118 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <string.h>
+#include "../scd41/sensirion_i2c_cmd.h"
 #include "sps30.h"
 #include "sensirion_arch_config.h"
 #include "../scd41/sensirion_common.h"
 #include "../scd41/sensirion_i2c.h"
+#include "../scd41/sensirion_i2c_hal.h"
 #include "sensirion_i2c.h"
 #include "sps_git_version.h"
 
-#define SPS_CMD_START_MEASUREMENT 0x0010
-#define SPS_CMD_START_MEASUREMENT_ARG 0x0300
-#define SPS_CMD_STOP_MEASUREMENT 0x0104
-#define SPS_CMD_READ_MEASUREMENT 0x0300
 #define SPS_CMD_START_STOP_DELAY_USEC 20000
-#define SPS_CMD_GET_DATA_READY 0x0202
-#define SPS_CMD_AUTOCLEAN_INTERVAL 0x8004
-#define SPS_CMD_GET_FIRMWARE_VERSION 0xd100
-#define SPS_CMD_GET_SERIAL 0xd033
-#define SPS_CMD_RESET 0xd304
-#define SPS_CMD_SLEEP 0x1001
-#define SPS_CMD_READ_DEVICE_STATUS_REG 0xd206
-#define SPS_CMD_START_MANUAL_FAN_CLEANING 0x5607
-#define SPS_CMD_WAKE_UP 0x1103
 #define SPS_CMD_DELAY_USEC 5000
 #define SPS_CMD_DELAY_WRITE_FLASH_USEC 20000
+/* The datasheet gives reads no execution time; as in the original driver
+ * the read follows the pointer write right away, in its own transfer */
+#define SPS_CMD_READ_DELAY_USEC 0
 
 #define SPS30_SERIAL_NUM_WORDS ((SPS30_MAX_SERIAL_LEN) / 2)
 
+enum sps30_cmd_id
+{
+    SPS30_CMD_START_MEASUREMENT,
+    SPS30_CMD_START_MEASUREMENT_U16,
+    SPS30_CMD_STOP_MEASUREMENT,
+    SPS30_CMD_READ_DATA_READY,
+    SPS30_CMD_READ_MEASUREMENT,
+    SPS30_CMD_READ_MEASUREMENT_U16,
+    SPS30_CMD_GET_AUTOCLEAN_INTERVAL,
+    SPS30_CMD_SET_AUTOCLEAN_INTERVAL,
+    SPS30_CMD_START_MANUAL_FAN_CLEANING,
+    SPS30_CMD_GET_FIRMWARE_VERSION,
+    SPS30_CMD_GET_SERIAL,
+    SPS30_CMD_RESET,
+    SPS30_CMD_SLEEP,
+    SPS30_CMD_WAKE_UP_INTERFACE,
+    SPS30_CMD_WAKE_UP,
+    SPS30_CMD_READ_DEVICE_STATUS_REG,
+};
+
+/*
+ * opcode, argument words, response words, execution time in us. Measurements
+ * are started in big-endian IEEE754 float format (0x0300, CRC 0xAC) or in
+ * unsigned 16-bit integer format (0x0500, CRC 0xF6).
+ */
+static const struct sensirion_i2c_cmd_desc sps30_cmds[] = {
+    [SPS30_CMD_START_MEASUREMENT] = SENSIRION_I2C_CMD_DESC_FIXED(
+        0x0010, SPS30_FORMAT_FLOAT, 0xAC, 0, SPS_CMD_START_STOP_DELAY_USEC),
+    [SPS30_CMD_START_MEASUREMENT_U16] = SENSIRION_I2C_CMD_DESC_FIXED(
+        0x0010, SPS30_FORMAT_UINT16, 0xF6, 0, SPS_CMD_START_STOP_DELAY_USEC),
+    [SPS30_CMD_STOP_MEASUREMENT] =
+        SENSIRION_I2C_CMD_DESC(0x0104, 0, 0, SPS_CMD_START_STOP_DELAY_USEC),
+    [SPS30_CMD_READ_DATA_READY] =
+        SENSIRION_I2C_CMD_DESC(0x0202, 0, 1, SPS_CMD_READ_DELAY_USEC),
+    [SPS30_CMD_READ_MEASUREMENT] = SENSIRION_I2C_CMD_DESC_FRAME(
+        0x0300, SPS30_MEASUREMENT_NUM_VALUES * 2, SPS_CMD_READ_DELAY_USEC),
+    [SPS30_CMD_READ_MEASUREMENT_U16] = SENSIRION_I2C_CMD_DESC_FRAME(
+        0x0300, SPS30_MEASUREMENT_NUM_VALUES, SPS_CMD_READ_DELAY_USEC),
+    [SPS30_CMD_GET_AUTOCLEAN_INTERVAL] =
+        SENSIRION_I2C_CMD_DESC(0x8004, 0, 2, SPS_CMD_DELAY_USEC),
+    [SPS30_CMD_SET_AUTOCLEAN_INTERVAL] =
+        SENSIRION_I2C_CMD_DESC(0x8004, 2, 0, SPS_CMD_DELAY_WRITE_FLASH_USEC),
+    [SPS30_CMD_START_MANUAL_FAN_CLEANING] =
+        SENSIRION_I2C_CMD_DESC(0x5607, 0, 0, SPS_CMD_DELAY_USEC),
+    [SPS30_CMD_GET_FIRMWARE_VERSION] =
+        SENSIRION_I2C_CMD_DESC(0xD100, 0, 1, SPS_CMD_READ_DELAY_USEC),
+    [SPS30_CMD_GET_SERIAL] = SENSIRION_I2C_CMD_DESC(
+        0xD033, 0, SPS30_SERIAL_NUM_WORDS, SPS_CMD_READ_DELAY_USEC),
+    [SPS30_CMD_RESET] =
+        SENSIRION_I2C_CMD_DESC(0xD304, 0, 0, SPS30_RESET_DELAY_USEC),
+    [SPS30_CMD_SLEEP] =
+        SENSIRION_I2C_CMD_DESC(0x1001, 0, 0, SPS_CMD_DELAY_USEC),
+    /* only wakes up the interface and is not acknowledged */
+    [SPS30_CMD_WAKE_UP_INTERFACE] = SENSIRION_I2C_CMD_DESC(0x1103, 0, 0, 0),
+    [SPS30_CMD_WAKE_UP] =
+        SENSIRION_I2C_CMD_DESC(0x1103, 0, 0, SPS_CMD_DELAY_USEC),
+    [SPS30_CMD_READ_DEVICE_STATUS_REG] =
+        SENSIRION_I2C_CMD_DESC(0xD206, 0, 2, SPS_CMD_DELAY_USEC),
+};
+
+/*
+ * Output phase of the running measurement. The first sample is due one
+ * interval after the start; every later one one interval after the last.
+ * The data-ready flag is only asked for when a sample is due. If it is not
+ * set yet, the sensor's clock drifted behind and the schedule slips by a
+ * short poll until the flag shows up, then follows the sensor again.
+ */
+static struct
+{
+    bool running;
+    uint16_t format; /* SPS30_FORMAT_* the measurement was started with */
+    int64_t next_ready; /* uptime in ms */
+} sps30_phase;
+
+/* Fields read by sps30_read_measurement_milli() */
+static uint16_t sps30_read_fields = SPS30_FIELDS_ALL;
+
 const char *sps_get_driver_version(void)
 {
     return SPS_DRV_VERSION_STR;
 }
 
+/*
+ * Run a command through the command layer. The sensor's execution time is
+ * tracked per address: write-only commands return once written and only delay
+ * the next command to the sensor, reads wait on a timer instead of sleeping.
+ * Response words are compacted into rx as plain bytes.
+ */
+static int16_t sps30_cmd(enum sps30_cmd_id id, const uint16_t *args, uint8_t *rx)
+{
+    return sensirion_i2c_cmd_run(SPS30_I2C_ADDRESS, &sps30_cmds[id], args, rx);
+}
+
 int16_t sps30_probe(void)
 {
     char serial[SPS30_MAX_SERIAL_LEN];
@@ -72,29 +153,29 @@ int16_t sps30_probe(void)
 
 int16_t sps30_read_firmware_version(uint8_t *major, uint8_t *minor)
 {
-    uint16_t version;
+    uint8_t data[SENSIRION_WORD_SIZE + CRC8_LEN];
     int16_t ret;
 
-    ret = sensirion_i2c_read_cmd(SPS30_I2C_ADDRESS,
-                                 SPS_CMD_GET_FIRMWARE_VERSION, &version, 1);
-    *major = (version & 0xff00) >> 8;
-    *minor = (version & 0x00ff);
-    return ret;
+    ret = sps30_cmd(SPS30_CMD_GET_FIRMWARE_VERSION, NULL, data);
+    if (ret)
+        return ret;
+
+    *major = data[0];
+    *minor = data[1];
+    return 0;
 }
 
 int16_t sps30_get_serial(char *serial)
 {
+    uint8_t data[SPS30_SERIAL_NUM_WORDS * (SENSIRION_WORD_SIZE + CRC8_LEN)];
     int16_t error;
 
-    error = sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_GET_SERIAL);
-
+    error = sps30_cmd(SPS30_CMD_GET_SERIAL, NULL, data);
     if (error != NO_ERROR)
     {
         return error;
     }
-
-    error = sensirion_i2c_read_words_as_bytes(
-        SPS30_I2C_ADDRESS, (uint8_t *)serial, SPS30_SERIAL_NUM_WORDS);
+    memcpy(serial, data, SPS30_MAX_SERIAL_LEN);
 
     /* ensure a final '\0'. The firmware should always set this so this is just
      * in case something goes wrong.
@@ -104,83 +185,237 @@ int16_t sps30_get_serial(char *serial)
     return error;
 }
 
-int16_t sps30_start_measurement(void)
+static int16_t sps30_start(enum sps30_cmd_id cmd, uint16_t format)
 {
-    const uint16_t arg = SPS_CMD_START_MEASUREMENT_ARG;
+    int16_t error = sps30_cmd(cmd, NULL, NULL);
 
-    int16_t ret = sensirion_i2c_write_cmd_with_args(
-        SPS30_I2C_ADDRESS, SPS_CMD_START_MEASUREMENT, &arg,
-        SENSIRION_NUM_WORDS(arg));
+    sps30_phase.running = error == NO_ERROR;
+    sps30_phase.format = format;
+    sps30_phase.next_ready = k_uptime_get() +
+                             SPS_CMD_START_STOP_DELAY_USEC / 1000 +
+                             SPS30_MEASUREMENT_INTERVAL_MS;
+    return error;
+}
 
-    sensirion_sleep_usec(SPS_CMD_START_STOP_DELAY_USEC);
+int16_t sps30_start_measurement(void)
+{
+    return sps30_start(SPS30_CMD_START_MEASUREMENT, SPS30_FORMAT_FLOAT);
+}
 
-    return ret;
+int16_t sps30_start_measurement_u16(void)
+{
+    return sps30_start(SPS30_CMD_START_MEASUREMENT_U16, SPS30_FORMAT_UINT16);
 }
 
 int16_t sps30_stop_measurement(void)
 {
-    int16_t ret =
-        sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_STOP_MEASUREMENT);
-    sensirion_sleep_usec(SPS_CMD_START_STOP_DELAY_USEC);
-    return ret;
+    sps30_phase.running = false;
+    return sps30_cmd(SPS30_CMD_STOP_MEASUREMENT, NULL, NULL);
 }
 
 int16_t sps30_read_data_ready(uint16_t *data_ready)
 {
-    return sensirion_i2c_read_cmd(SPS30_I2C_ADDRESS, SPS_CMD_GET_DATA_READY,
-                                  data_ready, SENSIRION_NUM_WORDS(*data_ready));
+    uint8_t data[SENSIRION_WORD_SIZE + CRC8_LEN];
+    int16_t ret;
+
+    ret = sps30_cmd(SPS30_CMD_READ_DATA_READY, NULL, data);
+    if (ret)
+        return ret;
+
+    *data_ready = sensirion_common_bytes_to_uint16_t(data);
+    return 0;
 }
 
+_Static_assert(sizeof(struct sps30_measurement) ==
+                   SPS30_MEASUREMENT_NUM_VALUES * sizeof(float),
+               "sps30_measurement must match the sensor's value order");
+
 int16_t sps30_read_measurement(struct sps30_measurement *measurement)
 {
     int16_t error;
-    uint8_t data[10][4];
+    uint8_t frame[SPS30_MEASUREMENT_NUM_VALUES * 2 *
+                  (SENSIRION_WORD_SIZE + CRC8_LEN)];
 
-    error =
-        sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_READ_MEASUREMENT);
+    if (sps30_phase.format == SPS30_FORMAT_UINT16)
+    {
+        struct sps30_measurement_milli milli;
+        const uint32_t *src = &milli.mc_1p0;
+        float *dst = &measurement->mc_1p0;
+
+        error = sps30_read_measurement_u16(&milli);
+        for (int i = 0; error == NO_ERROR && i < SPS30_MEASUREMENT_NUM_VALUES;
+             i++)
+        {
+            dst[i] = src[i] / 1000.0f;
+        }
+        return error;
+    }
+
+    error = sps30_cmd(SPS30_CMD_READ_MEASUREMENT, NULL, frame);
     if (error != NO_ERROR)
     {
         return error;
     }
 
-    error = sensirion_i2c_read_words_as_bytes(SPS30_I2C_ADDRESS, &data[0][0],
-                                              SENSIRION_NUM_WORDS(data));
+    /* CRCs are checked and values decoded straight from the receive buffer */
+    error = sensirion_i2c_decode_float(frame, SPS30_MEASUREMENT_NUM_VALUES,
+                                       &measurement->mc_1p0);
+    if (error == CRC_ERROR)
+    {
+        sensirion_i2c_report_crc_error(SPS30_I2C_ADDRESS, frame,
+                                       SPS30_MEASUREMENT_NUM_VALUES * 2);
+    }
+    return error;
+}
+
+_Static_assert(sizeof(struct sps30_measurement_milli) ==
+                   SPS30_MEASUREMENT_NUM_VALUES * sizeof(uint32_t),
+               "sps30_measurement_milli must match the sensor's value order");
 
+/* Index of the typical particle size, reported in nm by the integer format */
+#define SPS30_SIZE_INDEX (SPS30_MEASUREMENT_NUM_VALUES - 1)
+
+/*
+ * Read the values up to the last one in fields and stop the transfer there;
+ * the fields after it keep their contents. Values in front of the last one
+ * cost bus time anyway and are filled in too.
+ */
+static int16_t sps30_read_values(struct sps30_measurement_milli *measurement,
+                                 uint16_t fields, bool u16)
+{
+    uint8_t frame[SPS30_MEASUREMENT_NUM_VALUES * 2 *
+                  (SENSIRION_WORD_SIZE + CRC8_LEN)];
+    union
+    {
+        uint16_t u16[SPS30_MEASUREMENT_NUM_VALUES];
+        float f[SPS30_MEASUREMENT_NUM_VALUES];
+    } values;
+    struct sensirion_i2c_cmd_desc desc;
+    uint32_t *dst = &measurement->mc_1p0;
+    uint8_t num_values = SPS30_MEASUREMENT_NUM_VALUES;
+    int16_t error;
+
+    while (num_values > 0 && !(fields & (1 << (num_values - 1))))
+    {
+        num_values--;
+    }
+    if (num_values == 0)
+    {
+        return NO_ERROR;
+    }
+
+    desc = sps30_cmds[u16 ? SPS30_CMD_READ_MEASUREMENT_U16
+                          : SPS30_CMD_READ_MEASUREMENT];
+    desc.rx_words = u16 ? num_values : num_values * 2;
+    error = sensirion_i2c_cmd_run(SPS30_I2C_ADDRESS, &desc, NULL, frame);
     if (error != NO_ERROR)
     {
         return error;
     }
 
-    measurement->mc_1p0 = sensirion_bytes_to_float(data[0]);
-    measurement->mc_2p5 = sensirion_bytes_to_float(data[1]);
-    measurement->mc_4p0 = sensirion_bytes_to_float(data[2]);
-    measurement->mc_10p0 = sensirion_bytes_to_float(data[3]);
-    measurement->nc_0p5 = sensirion_bytes_to_float(data[4]);
-    measurement->nc_1p0 = sensirion_bytes_to_float(data[5]);
-    measurement->nc_2p5 = sensirion_bytes_to_float(data[6]);
-    measurement->nc_4p0 = sensirion_bytes_to_float(data[7]);
-    measurement->nc_10p0 = sensirion_bytes_to_float(data[8]);
-    measurement->typical_particle_size = sensirion_bytes_to_float(data[9]);
+    /* CRCs are checked and values decoded straight from the receive buffer */
+    error = u16 ? sensirion_i2c_decode_uint16(frame, num_values, values.u16)
+                : sensirion_i2c_decode_float(frame, num_values, values.f);
+    if (error == CRC_ERROR)
+    {
+        sensirion_i2c_report_crc_error(SPS30_I2C_ADDRESS, frame, desc.rx_words);
+        return error;
+    }
+    for (int i = 0; i < num_values; i++)
+    {
+        if (u16)
+        {
+            /* whole ug/m3 and #/cm3; the typical particle size is in nm */
+            dst[i] = i == SPS30_SIZE_INDEX ? values.u16[i] : values.u16[i] * 1000U;
+        }
+        else
+        {
+            /* float literals keep the conversion on the single precision FPU */
+            dst[i] = values.f[i] > 0.0f ? (uint32_t)(values.f[i] * 1000.0f + 0.5f)
+                                        : 0;
+        }
+    }
+    return NO_ERROR;
+}
+
+int16_t sps30_read_measurement_u16(struct sps30_measurement_milli *measurement)
+{
+    return sps30_read_values(measurement, SPS30_FIELDS_ALL, true);
+}
 
-    return 0;
+int16_t sps30_read_measurement_fields(struct sps30_measurement_milli *measurement,
+                                      uint16_t fields)
+{
+    return sps30_read_values(measurement, fields,
+                             sps30_phase.format == SPS30_FORMAT_UINT16);
 }
 
-int16_t sps30_get_fan_auto_cleaning_interval(uint32_t *interval_seconds)
+void sps30_set_read_fields(uint16_t fields)
+{
+    sps30_read_fields = fields;
+}
+
+int16_t sps30_read_measurement_milli(struct sps30_measurement_milli *measurement)
+{
+    return sps30_read_measurement_fields(measurement, sps30_read_fields);
+}
+
+int16_t sps30_read_measurement_aligned(struct sps30_measurement_milli *measurement)
 {
-    uint8_t data[4];
+    int64_t now = k_uptime_get();
+    uint16_t data_ready = 0;
     int16_t error;
 
-    error =
-        sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_AUTOCLEAN_INTERVAL);
+    if (sps30_phase.running &&
+        now < sps30_phase.next_ready + SPS30_PHASE_GUARD_MS)
+    {
+        return -EAGAIN;
+    }
+
+    error = sps30_read_data_ready(&data_ready);
     if (error != NO_ERROR)
     {
         return error;
     }
+    if (!data_ready)
+    {
+        sps30_phase.next_ready = now + SPS30_PHASE_POLL_MS - SPS30_PHASE_GUARD_MS;
+        return -EAGAIN;
+    }
+
+    error = sps30_read_measurement_milli(measurement);
+    if (error == NO_ERROR)
+    {
+        /* the sample completed at or before now, the next one follows within
+         * an interval; exact when the read ran right on schedule */
+        sps30_phase.next_ready = now - SPS30_PHASE_GUARD_MS +
+                                 SPS30_MEASUREMENT_INTERVAL_MS;
+    }
+    return error;
+}
+
+int32_t sps30_ms_until_ready(void)
+{
+    int64_t wait = sps30_phase.next_ready + SPS30_PHASE_GUARD_MS - k_uptime_get();
+
+    if (!sps30_phase.running || wait <= 0)
+    {
+        return 0;
+    }
+    return (int32_t)wait;
+}
 
-    sensirion_sleep_usec(SPS_CMD_DELAY_USEC);
+int32_t sps30_ms_until_idle(void)
+{
+    return sensirion_i2c_cmd_ms_until_idle(SPS30_I2C_ADDRESS);
+}
 
-    error = sensirion_i2c_read_words_as_bytes(SPS30_I2C_ADDRESS, data,
-                                              SENSIRION_NUM_WORDS(data));
+int16_t sps30_get_fan_auto_cleaning_interval(uint32_t *interval_seconds)
+{
+    uint8_t data[2 * (SENSIRION_WORD_SIZE + CRC8_LEN)];
+    int16_t error;
+
+    error = sps30_cmd(SPS30_CMD_GET_AUTOCLEAN_INTERVAL, NULL, data);
     if (error != NO_ERROR)
     {
         return error;
@@ -193,15 +428,10 @@ int16_t sps30_get_fan_auto_cleaning_interval(uint32_t *interval_seconds)
 
 int16_t sps30_set_fan_auto_cleaning_interval(uint32_t interval_seconds)
 {
-    int16_t ret;
     const uint16_t data[] = {(uint16_t)((interval_seconds & 0xFFFF0000) >> 16),
                              (uint16_t)(interval_seconds & 0x0000FFFF)};
 
-    ret = sensirion_i2c_write_cmd_with_args(SPS30_I2C_ADDRESS,
-                                            SPS_CMD_AUTOCLEAN_INTERVAL, data,
-                                            SENSIRION_NUM_WORDS(data));
-    sensirion_sleep_usec(SPS_CMD_DELAY_WRITE_FLASH_USEC);
-    return ret;
+    return sps30_cmd(SPS30_CMD_SET_AUTOCLEAN_INTERVAL, data, NULL);
 }
 
 int16_t sps30_get_fan_auto_cleaning_interval_days(uint8_t *interval_days)
@@ -225,58 +455,36 @@ int16_t sps30_set_fan_auto_cleaning_interval_days(uint8_t interval_days)
 
 int16_t sps30_start_manual_fan_cleaning(void)
 {
-    int16_t ret;
-
-    ret = sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS,
-                                  SPS_CMD_START_MANUAL_FAN_CLEANING);
-    if (ret)
-        return ret;
-
-    sensirion_sleep_usec(SPS_CMD_DELAY_USEC);
-    return 0;
+    return sps30_cmd(SPS30_CMD_START_MANUAL_FAN_CLEANING, NULL, NULL);
 }
 
 int16_t sps30_reset(void)
 {
-    return sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_RESET);
+    sps30_phase.running = false;
+    return sps30_cmd(SPS30_CMD_RESET, NULL, NULL);
 }
 
 int16_t sps30_sleep(void)
 {
-    int16_t ret;
-
-    ret = sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_SLEEP);
-    if (ret)
-        return ret;
-
-    sensirion_sleep_usec(SPS_CMD_DELAY_USEC);
-    return 0;
+    sps30_phase.running = false;
+    return sps30_cmd(SPS30_CMD_SLEEP, NULL, NULL);
 }
 
 int16_t sps30_wake_up(void)
 {
-    int16_t ret;
-
-    (void)sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_WAKE_UP);
-    ret = sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_WAKE_UP);
-    if (ret)
-        return ret;
-
-    sensirion_sleep_usec(SPS_CMD_DELAY_USEC);
-    return 0;
+    (void)sps30_cmd(SPS30_CMD_WAKE_UP_INTERFACE, NULL, NULL);
+    return sps30_cmd(SPS30_CMD_WAKE_UP, NULL, NULL);
 }
 
 int16_t sps30_read_device_status_register(uint32_t *device_status_flags)
 {
+    uint8_t data[2 * (SENSIRION_WORD_SIZE + CRC8_LEN)];
     int16_t ret;
-    uint16_t word_buf[2];
 
-    ret = sensirion_i2c_delayed_read_cmd(
-        SPS30_I2C_ADDRESS, SPS_CMD_READ_DEVICE_STATUS_REG, SPS_CMD_DELAY_USEC,
-        word_buf, SENSIRION_NUM_WORDS(word_buf));
+    ret = sps30_cmd(SPS30_CMD_READ_DEVICE_STATUS_REG, NULL, data);
     if (ret)
         return ret;
 
-    *device_status_flags = (((uint32_t)word_buf[0]) << 16) | word_buf[1];
+    *device_status_flags = sensirion_bytes_to_uint32_t(data);
     return 0;
-}
\ No newline at end of file
+}
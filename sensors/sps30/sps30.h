@@ -45,6 +45,29 @@ extern "C"
 #define SPS30_MAX_SERIAL_LEN 32
 /* 1s measurement intervals */
 #define SPS30_MEASUREMENT_DURATION_USEC 1000000
+#define SPS30_MEASUREMENT_INTERVAL_MS 1000
+/* Fields of a measurement, in the order the sensor sends them */
+#define SPS30_FIELD_MC_1P0 (1 << 0)
+#define SPS30_FIELD_MC_2P5 (1 << 1)
+#define SPS30_FIELD_MC_4P0 (1 << 2)
+#define SPS30_FIELD_MC_10P0 (1 << 3)
+#define SPS30_FIELD_NC_0P5 (1 << 4)
+#define SPS30_FIELD_NC_1P0 (1 << 5)
+#define SPS30_FIELD_NC_2P5 (1 << 6)
+#define SPS30_FIELD_NC_4P0 (1 << 7)
+#define SPS30_FIELD_NC_10P0 (1 << 8)
+#define SPS30_FIELD_TYPICAL_PARTICLE_SIZE (1 << 9)
+#define SPS30_FIELDS_MASS 0x000F
+#define SPS30_FIELDS_ALL 0x03FF
+/* Output formats, the argument of the start measurement command */
+#define SPS30_FORMAT_FLOAT 0x0300
+#define SPS30_FORMAT_UINT16 0x0500
+/* Margin after the expected output of a sample before it is read */
+#define SPS30_PHASE_GUARD_MS 20
+/* Poll interval while the sensor is behind its expected output */
+#define SPS30_PHASE_POLL_MS 100
+/* Number of float values in struct sps30_measurement */
+#define SPS30_MEASUREMENT_NUM_VALUES 10
 /* 100ms delay after resetting the sensor */
 #define SPS30_RESET_DELAY_USEC 100000
 /** The fan is switched on but not running */
@@ -68,6 +91,23 @@ extern "C"
         float typical_particle_size;
     };
 
+    /* struct sps30_measurement in integer milli-units: mass concentrations in
+     * ng/m3, number concentrations in 1/dm3 (milli #/cm3) and the typical
+     * particle size in nm. */
+    struct sps30_measurement_milli
+    {
+        uint32_t mc_1p0;
+        uint32_t mc_2p5;
+        uint32_t mc_4p0;
+        uint32_t mc_10p0;
+        uint32_t nc_0p5;
+        uint32_t nc_1p0;
+        uint32_t nc_2p5;
+        uint32_t nc_4p0;
+        uint32_t nc_10p0;
+        uint32_t typical_particle_size;
+    };
+
     /**
      * sps_get_driver_version() - Return the driver version
      * Return:  Driver version string
@@ -115,6 +155,19 @@ extern "C"
      */
     int16_t sps30_start_measurement(void);
 
+    /**
+     * sps30_start_measurement_u16() - start measuring with unsigned 16-bit
+     * integer output
+     *
+     * Each reading moves 30 instead of 60 bytes and needs no float decoding,
+     * at a resolution of 1 ug/m3, 1 #/cm3 and 1 nm. The read functions decode
+     * whichever format the measurement was started with. Requires firmware
+     * 2.0 or later.
+     *
+     * Return:  0 on success, an error code otherwise
+     */
+    int16_t sps30_start_measurement_u16(void);
+
     /**
      * sps30_stop_measurement() - stop measuring
      *
@@ -144,6 +197,76 @@ extern "C"
      */
     int16_t sps30_read_measurement(struct sps30_measurement *measurement);
 
+    /**
+     * sps30_read_measurement_milli() - read a measurement in milli-units
+     *
+     * Like sps30_read_measurement(), but converted to integers with single
+     * precision float math only.
+     *
+     * Return:  0 on success, an error code otherwise
+     */
+    int16_t sps30_read_measurement_milli(struct sps30_measurement_milli *measurement);
+
+    /**
+     * sps30_read_measurement_fields() - read part of a measurement
+     *
+     * The read stops after the last field in fields, so e.g.
+     * SPS30_FIELDS_MASS moves 4 of the 10 values. Fields in front of the
+     * last requested one are filled in as well; the ones after it are left
+     * untouched. Reading a measurement clears the data-ready flag however
+     * many fields were read.
+     *
+     * @fields: SPS30_FIELD_* mask
+     * Return:  0 on success, an error code otherwise
+     */
+    int16_t sps30_read_measurement_fields(struct sps30_measurement_milli *measurement,
+                                          uint16_t fields);
+
+    /**
+     * sps30_set_read_fields() - select the fields read by
+     * sps30_read_measurement_milli() and sps30_read_measurement_aligned()
+     *
+     * @fields: SPS30_FIELD_* mask, SPS30_FIELDS_ALL by default
+     */
+    void sps30_set_read_fields(uint16_t fields);
+
+    /**
+     * sps30_read_measurement_u16() - read a measurement started with
+     * sps30_start_measurement_u16() into milli-units
+     *
+     * Return:  0 on success, an error code otherwise
+     */
+    int16_t sps30_read_measurement_u16(struct sps30_measurement_milli *measurement);
+
+    /**
+     * sps30_read_measurement_aligned() - read the next fresh measurement
+     *
+     * Follows the sensor's 1 Hz output: nothing is sent to the sensor before
+     * the next sample is due, then the data-ready flag is checked once and
+     * the sample read. Never waits.
+     *
+     * Return:  0 on success, -EAGAIN if no fresh sample is available yet, an
+     *          error code otherwise
+     */
+    int16_t sps30_read_measurement_aligned(struct sps30_measurement_milli *measurement);
+
+    /**
+     * sps30_ms_until_ready() - time until sps30_read_measurement_aligned() can
+     * return the next sample
+     *
+     * Return:  milliseconds to wait, 0 if a sample is due or no measurement runs
+     */
+    int32_t sps30_ms_until_ready(void);
+
+    /**
+     * sps30_ms_until_idle() - time until the sensor has finished executing
+     * its last command, e.g. a start, stop or wake-up
+     *
+     * Return:  milliseconds until the next command is sent without waiting,
+     *          0 if the sensor is idle
+     */
+    int32_t sps30_ms_until_idle(void);
+
     /**
      * sps30_get_fan_auto_cleaning_interval() - read the current(*) auto-cleaning
      * interval
@@ -0,0 +1,325 @@
+#include <string.h>
+#include "../scd41/sensirion_i2c_cmd.h"
+#include "sps30_duty.h"
+#include "sps30_health.h"
+
+enum sps30_duty_state
+{
+    SPS30_DUTY_CONTINUOUS,
+    SPS30_DUTY_ASLEEP,
+    SPS30_DUTY_WAKING,   /* woken up, measurement not started yet */
+    SPS30_DUTY_STARTING, /* measurement started, cleaning not checked yet */
+    SPS30_DUTY_WARMING,
+    SPS30_DUTY_AVERAGING,
+    SPS30_DUTY_STOPPING, /* measurement stopped, not asleep yet */
+};
+
+static struct
+{
+    enum sps30_duty_state state;
+    uint32_t interval_ms;
+    uint32_t spinup_ms;
+    uint8_t samples;
+    uint8_t count;
+    bool continuous; /* measures between reports */
+    bool u16; /* firmware supports the integer output format */
+    int64_t warm_until; /* uptime in ms */
+    int64_t last_clean; /* uptime in ms */
+    uint64_t sum[SPS30_MEASUREMENT_NUM_VALUES];
+} sps30_duty;
+
+static int16_t sps30_duty_measure(void)
+{
+    return sps30_duty.u16 ? sps30_start_measurement_u16()
+                          : sps30_start_measurement();
+}
+
+/*
+ * Every step sends at most one command with an execution time and returns
+ * -EAGAIN while the sensor still executes the previous one, so the caller
+ * comes back after sps30_duty_ms_until_ready() instead of waiting.
+ */
+static bool sps30_duty_busy(void)
+{
+    return sps30_ms_until_idle() > 0;
+}
+
+/* Wake the sensor and start measuring, then measure continuously if target
+ * says so or spin up for a reading, with a fan cleaning if one is due. */
+static int16_t sps30_duty_wake_step(enum sps30_duty_state target)
+{
+    int64_t now = k_uptime_get();
+    int16_t error;
+
+    if (sps30_duty_busy())
+    {
+        return -EAGAIN;
+    }
+    switch (sps30_duty.state)
+    {
+    case SPS30_DUTY_ASLEEP:
+        error = sps30_wake_up();
+        if (error != NO_ERROR)
+        {
+            return error;
+        }
+        sps30_duty.state = SPS30_DUTY_WAKING;
+        return -EAGAIN;
+    case SPS30_DUTY_WAKING:
+        error = sps30_duty_measure();
+        if (error != NO_ERROR)
+        {
+            return error;
+        }
+        if (target == SPS30_DUTY_CONTINUOUS)
+        {
+            sps30_duty.state = SPS30_DUTY_CONTINUOUS;
+            return NO_ERROR;
+        }
+        sps30_duty.state = SPS30_DUTY_STARTING;
+        sps30_duty.warm_until = now + sps30_duty.spinup_ms;
+        sps30_duty.count = 0;
+        return -EAGAIN;
+    case SPS30_DUTY_STARTING:
+        /* cleaning takes 10 s and is hidden in the spin-up, which is also
+         * where the cleanings asked for by the health check run */
+        if ((now - sps30_duty.last_clean >= SPS30_DUTY_CLEAN_INTERVAL_MS ||
+             sps30_health_clean_wanted()) &&
+            sps30_health_clean() == NO_ERROR)
+        {
+            sps30_duty.last_clean = now;
+        }
+        sps30_duty.state = SPS30_DUTY_WARMING;
+        return NO_ERROR;
+    default:
+        return NO_ERROR;
+    }
+}
+
+/* Stop measuring, then sleep once the stop has executed. */
+static int16_t sps30_duty_sleep_step(void)
+{
+    int16_t error;
+
+    if (sps30_duty.state == SPS30_DUTY_ASLEEP)
+    {
+        return NO_ERROR;
+    }
+    if (sps30_duty_busy())
+    {
+        return -EAGAIN;
+    }
+    if (sps30_duty.state != SPS30_DUTY_WAKING &&
+        sps30_duty.state != SPS30_DUTY_STOPPING)
+    {
+        error = sps30_stop_measurement();
+        if (error != NO_ERROR)
+        {
+            return error;
+        }
+        sps30_duty.state = SPS30_DUTY_STOPPING;
+        return -EAGAIN;
+    }
+    error = sps30_sleep();
+    if (error != NO_ERROR)
+    {
+        return error;
+    }
+    sps30_duty.state = SPS30_DUTY_ASLEEP;
+    return NO_ERROR;
+}
+
+int16_t sps30_duty_start(uint32_t interval_ms, uint32_t spinup_ms,
+                         uint8_t samples)
+{
+    uint8_t major = 0;
+    uint8_t minor = 0;
+    uint32_t on_ms;
+
+    sps30_duty.interval_ms = interval_ms;
+    sps30_duty.spinup_ms = spinup_ms;
+    sps30_duty.samples = CLAMP(samples, 1, SPS30_DUTY_MAX_SAMPLES);
+    sps30_duty.last_clean = k_uptime_get();
+    /* integer output halves the transfer and skips the float decoding */
+    sps30_duty.u16 = sps30_read_firmware_version(&major, &minor) == NO_ERROR &&
+                     major >= 2;
+
+    on_ms = spinup_ms + sps30_duty.samples * SPS30_MEASUREMENT_INTERVAL_MS;
+    sps30_duty.continuous = (uint64_t)on_ms * 2 > interval_ms;
+    if (sps30_duty.continuous)
+    {
+        sps30_duty.state = SPS30_DUTY_CONTINUOUS;
+        return sps30_duty_measure();
+    }
+
+    sps30_duty.state = SPS30_DUTY_ASLEEP;
+    return sps30_sleep();
+}
+
+int16_t sps30_duty_wake(void)
+{
+    return sps30_duty_wake_step(SPS30_DUTY_WARMING);
+}
+
+static void sps30_duty_average(struct sps30_measurement_milli *measurement)
+{
+    uint32_t *dst = &measurement->mc_1p0;
+
+    for (int i = 0; i < SPS30_MEASUREMENT_NUM_VALUES; i++)
+    {
+        dst[i] = (sps30_duty.sum[i] + sps30_duty.count / 2) / sps30_duty.count;
+    }
+}
+
+int16_t sps30_duty_read(struct sps30_measurement_milli *measurement)
+{
+    /* fields left out by sps30_set_read_fields() average to 0 */
+    struct sps30_measurement_milli m = {0};
+    const uint32_t *src = &m.mc_1p0;
+    int16_t error;
+
+    switch (sps30_duty.state)
+    {
+    case SPS30_DUTY_CONTINUOUS:
+        if (sps30_duty_busy())
+        {
+            return -EAGAIN;
+        }
+        return sps30_read_measurement_aligned(measurement);
+    case SPS30_DUTY_ASLEEP:
+    case SPS30_DUTY_WAKING:
+    case SPS30_DUTY_STARTING:
+        error = sps30_duty_wake();
+        return error != NO_ERROR ? error : -EAGAIN;
+    case SPS30_DUTY_STOPPING:
+        /* a complete reading is returned once the sensor sleeps */
+        error = sps30_duty_sleep_step();
+        if (error == -EAGAIN)
+        {
+            return error;
+        }
+        sps30_duty.state = SPS30_DUTY_ASLEEP;
+        if (sps30_duty.count < sps30_duty.samples)
+        {
+            /* suspended halfway through, start over */
+            error = sps30_duty_wake();
+            return error != NO_ERROR ? error : -EAGAIN;
+        }
+        sps30_duty_average(measurement);
+        sps30_duty.count = 0;
+        return NO_ERROR;
+    case SPS30_DUTY_WARMING:
+        if (k_uptime_get() < sps30_duty.warm_until)
+        {
+            return -EAGAIN;
+        }
+        sps30_duty.state = SPS30_DUTY_AVERAGING;
+        sps30_duty.count = 0;
+        memset(sps30_duty.sum, 0, sizeof(sps30_duty.sum));
+        break;
+    default:
+        break;
+    }
+
+    /* e.g. a cleaning started by the health check */
+    if (sps30_duty_busy())
+    {
+        return -EAGAIN;
+    }
+    error = sps30_read_measurement_aligned(&m);
+    if (error != NO_ERROR)
+    {
+        return error;
+    }
+    for (int i = 0; i < SPS30_MEASUREMENT_NUM_VALUES; i++)
+    {
+        sps30_duty.sum[i] += src[i];
+    }
+    if (++sps30_duty.count < sps30_duty.samples)
+    {
+        return -EAGAIN;
+    }
+
+    /* The sleep follows once the stop has executed. Should either fail,
+     * the next wake-up reports it; the reading is valid. */
+    if (sps30_duty_sleep_step() == -EAGAIN)
+    {
+        return -EAGAIN;
+    }
+    sps30_duty.state = SPS30_DUTY_ASLEEP;
+    sps30_duty_average(measurement);
+    sps30_duty.count = 0;
+    return NO_ERROR;
+}
+
+int32_t sps30_duty_ms_until_ready(void)
+{
+    int32_t idle = sps30_ms_until_idle();
+    int64_t wait;
+
+    switch (sps30_duty.state)
+    {
+    case SPS30_DUTY_WARMING:
+        wait = sps30_duty.warm_until - k_uptime_get();
+        return MAX(wait > 0 ? (int32_t)wait : 0, idle);
+    case SPS30_DUTY_CONTINUOUS:
+    case SPS30_DUTY_AVERAGING:
+        return MAX(sps30_ms_until_ready(), idle);
+    default:
+        return idle;
+    }
+}
+
+int16_t sps30_duty_suspend(void)
+{
+    return sps30_duty_sleep_step();
+}
+
+int16_t sps30_duty_resume(void)
+{
+    int16_t error;
+
+    if (!sps30_duty.continuous)
+    {
+        return NO_ERROR;
+    }
+    if (sps30_duty.state == SPS30_DUTY_STOPPING)
+    {
+        /* a suspend still under way */
+        error = sps30_duty_sleep_step();
+        if (error != NO_ERROR)
+        {
+            return error;
+        }
+    }
+    if (sps30_duty.state != SPS30_DUTY_ASLEEP &&
+        sps30_duty.state != SPS30_DUTY_WAKING)
+    {
+        return NO_ERROR;
+    }
+    return sps30_duty_wake_step(SPS30_DUTY_CONTINUOUS);
+}
+
+bool sps30_duty_awake(void)
+{
+    switch (sps30_duty.state)
+    {
+    case SPS30_DUTY_CONTINUOUS:
+    case SPS30_DUTY_STARTING:
+    case SPS30_DUTY_WARMING:
+    case SPS30_DUTY_AVERAGING:
+        return true;
+    default:
+        return false;
+    }
+}
+
+int32_t sps30_duty_ms_until_wake(void)
+{
+    if (sps30_duty.state == SPS30_DUTY_CONTINUOUS)
+    {
+        return -1;
+    }
+    return sps30_duty.interval_ms - sps30_duty.spinup_ms -
+           sps30_duty.samples * SPS30_MEASUREMENT_INTERVAL_MS;
+}
@@ -0,0 +1,82 @@
+#ifndef SPS30_DUTY_H
+#define SPS30_DUTY_H
+
+#include "sps30.h"
+
+/* Maximum number of readings averaged per report. */
+#define SPS30_DUTY_MAX_SAMPLES 30
+/* Time between two manual fan cleanings while duty cycling. Sleeping resets
+ * the sensor's auto-cleaning timer, so it would never run. */
+#define SPS30_DUTY_CLEAN_INTERVAL_MS (7LL * 24 * 60 * 60 * 1000)
+
+/**
+ * Start measuring for reports every interval_ms. If the sensor would be
+ * running more than half of the time anyway it measures continuously;
+ * otherwise it sleeps between reports and is woken spinup_ms before the
+ * next one.
+ *
+ * @param interval_ms Time between two reports
+ * @param spinup_ms   Fan spin-up time before readings are stable
+ * @param samples     Number of readings averaged per report
+ * @returns 0 on success, an error code otherwise
+ */
+int16_t sps30_duty_start(uint32_t interval_ms, uint32_t spinup_ms,
+                         uint8_t samples);
+
+/**
+ * Wake the sensor and start measuring ahead of the next report. Does nothing
+ * while the sensor is awake. Like all calls below it never waits for the
+ * sensor: each call sends at most one command with an execution time and
+ * returns -EAGAIN until the sequence is through, to be called again after
+ * sps30_duty_ms_until_ready().
+ *
+ * @returns 0 on success, -EAGAIN while waking up, an error code otherwise
+ */
+int16_t sps30_duty_wake(void);
+
+/**
+ * Take the reading for a report: wakes the sensor if it sleeps, waits out
+ * the spin-up, averages the configured number of readings, then stops and
+ * sleeps the sensor. The reading is returned once the sensor sleeps.
+ *
+ * @returns 0 on success, -EAGAIN while the reading is not complete, an error
+ *          code otherwise
+ */
+int16_t sps30_duty_read(struct sps30_measurement_milli *measurement);
+
+/**
+ * @returns milliseconds until sps30_duty_read() can make progress, 0 if it
+ *          can right away
+ */
+int32_t sps30_duty_ms_until_ready(void);
+
+/**
+ * Stop measuring and sleep until sps30_duty_resume(), also when the sensor
+ * measures continuously. A read in between wakes it like a duty-cycled one.
+ *
+ * @returns 0 on success, -EAGAIN until the sensor sleeps, an error code
+ *          otherwise
+ */
+int16_t sps30_duty_suspend(void);
+
+/**
+ * Measure continuously again if the sensor did before sps30_duty_suspend().
+ * A duty-cycled sensor keeps sleeping until its next wake-up.
+ *
+ * @returns 0 on success, -EAGAIN until the measurement runs, an error code
+ *          otherwise
+ */
+int16_t sps30_duty_resume(void);
+
+/**
+ * @returns true while the sensor measures, i.e. its fan runs
+ */
+bool sps30_duty_awake(void);
+
+/**
+ * @returns milliseconds after a completed reading until sps30_duty_wake()
+ *          is due for the next report, or -1 if the sensor does not sleep
+ */
+int32_t sps30_duty_ms_until_wake(void);
+
+#endif
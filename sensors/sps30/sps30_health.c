@@ -0,0 +1,133 @@
+#include "../scd41/sensirion_i2c_cmd.h"
+#include "sps30_health.h"
+
+static struct
+{
+    bool supported; /* firmware has the status register */
+    bool clean_wanted;
+    uint32_t status;
+    int64_t last_check;  /* uptime in ms, 0 if never checked */
+    int64_t clean_until; /* uptime in ms */
+    int64_t last_clean;  /* uptime in ms, 0 if none asked for */
+} sps30_health;
+
+static const char *const sps30_health_names[] = {
+    [SPS30_HEALTH_UNKNOWN] = "unknown",
+    [SPS30_HEALTH_OK] = "ok",
+    [SPS30_HEALTH_CLEANING] = "cleaning",
+    [SPS30_HEALTH_DEGRADED] = "degraded",
+    [SPS30_HEALTH_FAULT] = "fault",
+};
+
+int16_t sps30_health_start(void)
+{
+    uint8_t major = 0;
+    uint8_t minor = 0;
+    int16_t error;
+
+    sps30_health.supported = false;
+    sps30_health.clean_wanted = false;
+    sps30_health.status = 0;
+    sps30_health.last_check = 0;
+    sps30_health.clean_until = 0;
+
+    error = sps30_read_firmware_version(&major, &minor);
+    if (error != NO_ERROR)
+    {
+        return error;
+    }
+    sps30_health.supported = major > 2 || (major == 2 && minor >= 2);
+    return NO_ERROR;
+}
+
+int16_t sps30_health_check(void)
+{
+    int64_t now = k_uptime_get();
+    uint32_t status;
+    int16_t error;
+
+    if (!sps30_health.supported)
+    {
+        return NO_ERROR;
+    }
+    error = sps30_read_device_status_register(&status);
+    if (error != NO_ERROR)
+    {
+        return error;
+    }
+    sps30_health.status = status;
+    sps30_health.last_check = now;
+
+    /* a fan slowed down by dust often recovers with a cleaning */
+    if ((status & SPS30_HEALTH_CLEAN_MASK) &&
+        (sps30_health.last_clean == 0 ||
+         now - sps30_health.last_clean >= SPS30_HEALTH_CLEAN_RETRY_MS))
+    {
+        sps30_health.clean_wanted = true;
+    }
+    return NO_ERROR;
+}
+
+bool sps30_health_clean_wanted(void)
+{
+    return sps30_health.clean_wanted;
+}
+
+int16_t sps30_health_clean(void)
+{
+    int64_t now = k_uptime_get();
+    int16_t error;
+
+    error = sps30_start_manual_fan_cleaning();
+    if (error != NO_ERROR)
+    {
+        return error;
+    }
+    sps30_health.clean_wanted = false;
+    sps30_health.last_clean = now;
+    sps30_health.clean_until =
+        now + SPS30_HEALTH_CLEAN_MS + SPS30_HEALTH_CLEAN_SETTLE_MS;
+    return NO_ERROR;
+}
+
+enum sps30_health_state sps30_health_state(void)
+{
+    if (k_uptime_get() < sps30_health.clean_until)
+    {
+        return SPS30_HEALTH_CLEANING;
+    }
+    if (sps30_health.last_check == 0)
+    {
+        return SPS30_HEALTH_UNKNOWN;
+    }
+    if (sps30_health.status & SPS30_HEALTH_FAULT_MASK)
+    {
+        return SPS30_HEALTH_FAULT;
+    }
+    if (sps30_health.status & SPS30_DEVICE_STATUS_FAN_SPEED_WARNING)
+    {
+        return SPS30_HEALTH_DEGRADED;
+    }
+    return SPS30_HEALTH_OK;
+}
+
+bool sps30_health_reading_valid(void)
+{
+    enum sps30_health_state state = sps30_health_state();
+
+    return state == SPS30_HEALTH_OK || state == SPS30_HEALTH_UNKNOWN;
+}
+
+uint32_t sps30_health_status(void)
+{
+    return sps30_health.status;
+}
+
+const char *sps30_health_state_str(enum sps30_health_state state)
+{
+    if ((unsigned int)state >= ARRAY_SIZE(sps30_health_names))
+    {
+        return "unknown";
+    }
+    return sps30_health_names[state];
+}
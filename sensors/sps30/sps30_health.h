@@ -0,0 +1,80 @@
+#ifndef SPS30_HEALTH_H
+#define SPS30_HEALTH_H
+
+#include "sps30.h"
+
+/* Status flags that make the readings unusable */
+#define SPS30_HEALTH_FAULT_MASK                                              \
+    (SPS30_DEVICE_STATUS_FAN_ERROR_MASK | SPS30_DEVICE_STATUS_LASER_ERROR_MASK)
+/* Status flags that ask for a fan cleaning */
+#define SPS30_HEALTH_CLEAN_MASK                                              \
+    (SPS30_DEVICE_STATUS_FAN_ERROR_MASK | SPS30_DEVICE_STATUS_FAN_SPEED_WARNING)
+/* A manual fan cleaning runs the fan at full speed for 10 s; readings until
+ * the fan settled afterwards are not used. */
+#define SPS30_HEALTH_CLEAN_MS 10000
+#define SPS30_HEALTH_CLEAN_SETTLE_MS 2000
+/* Minimum time between two cleanings asked for by the status flags */
+#define SPS30_HEALTH_CLEAN_RETRY_MS (60 * 60 * 1000)
+
+enum sps30_health_state
+{
+    SPS30_HEALTH_UNKNOWN,  /* not checked yet, or firmware before 2.2 */
+    SPS30_HEALTH_OK,
+    SPS30_HEALTH_CLEANING, /* fan cleaning running or settling */
+    SPS30_HEALTH_DEGRADED, /* fan speed out of range */
+    SPS30_HEALTH_FAULT,    /* fan stopped or laser current out of range */
+};
+
+/**
+ * Reset the health state after the sensor was (re)initialized. Reads the
+ * firmware version; the status register needs firmware 2.2 or newer.
+ *
+ * @returns 0 on success, an error code otherwise
+ */
+int16_t sps30_health_start(void);
+
+/**
+ * Read the device status register and update the health state. The flags
+ * clear themselves once the condition is gone. Does nothing on firmware
+ * without the status register. The sensor must be awake.
+ *
+ * @returns 0 on success, an error code otherwise
+ */
+int16_t sps30_health_check(void);
+
+/**
+ * @returns true if the last check asked for a fan cleaning that has not been
+ *          run yet
+ */
+bool sps30_health_clean_wanted(void);
+
+/**
+ * Start a manual fan cleaning. The sensor must be measuring. Readings are
+ * marked invalid until the cleaning is over and the fan settled.
+ *
+ * @returns 0 on success, an error code otherwise
+ */
+int16_t sps30_health_clean(void);
+
+/**
+ * @returns the current health state
+ */
+enum sps30_health_state sps30_health_state(void);
+
+/**
+ * @returns true if readings taken now can be used: the sensor is not
+ *          cleaning, and no fault or fan speed warning is flagged
+ */
+bool sps30_health_reading_valid(void);
+
+/**
+ * @returns the last device status register value, 0 if never read
+ */
+uint32_t sps30_health_status(void);
+
+/**
+ * @returns a short name of a health state, e.g. for telemetry
+ */
+const char *sps30_health_state_str(enum sps30_health_state state);
+
+#endif
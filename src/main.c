@@ -1,132 +1,957 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
+#if defined(CONFIG_OPENTHREAD_COAP)
 #include <zephyr/net/openthread.h>
 #include <zephyr/net/coap.h>
 #include <openthread/thread.h>
 #include <openthread/udp.h>
 #include <openthread/coap.h>
-#include <zephyr/drivers/sensor.h>
+#endif
 #include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/pm/device_runtime.h>
 #include <zephyr/sys/printk.h>
 #include <zephyr/sys/util.h>
 #include "../sensors/scd41/scd4x_i2c.h"
+#include "../sensors/scd41/scd4x_power.h"
+#include "../sensors/scd41/scd4x_pressure.h"
 #include "../sensors/scd41/sensirion_common.h"
 #include "../sensors/scd41/sensirion_i2c_hal.h"
-#include "../sensors/ccs811/ccs811.h"
+#include "../sensors/ccs811/ccs811_sensor.h"
+#include "../sensors/ccs811/ccs811_baseline.h"
 #include "../sensors/sps30/sps30.h"
+#include "../sensors/sps30/sps30_duty.h"
+#include "../sensors/sps30/sps30_health.h"
+#include "../sensors/i2c/i2c_bus.h"
+#include "../sensors/i2c/i2c_stats.h"
+#include "../sensors/i2c/i2c_recovery.h"
+#include "../sensors/scd41/sensirion_i2c.h"
+#include "sample.h"
+#include "sensor_registry.h"
 
 #define SLEEP_TIME_MS 1000
 #define DATA_SENDING_INTERVAL 60000
 #define TEXTBUFFER_SIZE 30
 #define BUTTON0_NODE DT_NODELABEL(button0)
 #define BUTTON1_NODE DT_NODELABEL(button1)
+/* Optional barometer for the SCD41 pressure compensation */
+#define BAROMETER_NODE DT_ALIAS(barometer)
+#define ACQUISITION_STACK_SIZE 2048
+#define ACQUISITION_PRIORITY 5
+/* Sensors without a fresh sample are polled again after ACQUISITION_POLL_MS,
+ * at most ACQUISITION_MAX_POLLS times per cycle. */
+#define ACQUISITION_POLL_MS 250
+#define ACQUISITION_MAX_POLLS 24
+#ifdef CONFIG_APP_SENSOR_SPS30
+/* Waking the SPS30, starting its measurement, the spin-up and putting it to
+ * sleep take a poll each, every reading it averages up to two when its
+ * data-ready flag lags */
+BUILD_ASSERT(4 + 2 * CONFIG_APP_SPS30_AVERAGE_SAMPLES <= ACQUISITION_MAX_POLLS,
+             "SPS30 averaging does not fit the acquisition poll budget");
+#endif
+#define I2C_STATS_JSON_SIZE 1024
+/* Changes in the SCD41 readings from which the CCS811 compensation is
+ * updated; smaller ones barely move its results. */
+#define CCS811_ENV_TEMPERATURE_STEP 500 /* m°C */
+#define CCS811_ENV_HUMIDITY_STEP 2000   /* m%RH */
+/* A failed CCS811 baseline update is retried after this long */
+#define CCS811_BASELINE_RETRY_MS 60000
+/* The SPS30 status is checked this long before a duty-cycled spin-up ends */
+#define SPS30_HEALTH_CHECK_LEAD_MS 1000
 
 static const struct gpio_dt_spec button0_spec = GPIO_DT_SPEC_GET(BUTTON0_NODE, gpios);
 static const struct gpio_dt_spec button1_spec = GPIO_DT_SPEC_GET(BUTTON1_NODE, gpios);
 static struct gpio_callback button_cb;
 
 static struct k_timer send_timer;
+static struct k_work_q acquisition_work_q;
+static K_THREAD_STACK_DEFINE(acquisition_stack, ACQUISITION_STACK_SIZE);
 static volatile bool function_running = false;
 static char sensors_data[256];
 
-int16_t get_serial(int16_t error, int16_t serial_0, int16_t serial_1, int16_t serial_2);
-void read_scd41();
-void read_ccs811(struct ccs811_data *ccs811);
-void read_sps30();
-
+static void acquire_sensor_data(struct k_work *work);
 static void coap_send_data_request(struct k_work *work);
+#if defined(CONFIG_OPENTHREAD_COAP)
 static void coap_send_data_response_cb(void *p_context, otMessage *p_message, const otMessageInfo *p_message_info, otError result);
+static void coap_i2c_stats_handler(void *p_context, otMessage *p_message, const otMessageInfo *p_message_info);
+#if defined(CONFIG_APP_SENSOR_SCD41)
+static void coap_pressure_handler(void *p_context, otMessage *p_message, const otMessageInfo *p_message_info);
+
+static otCoapResource pressure_resource = {
+        .mUriPath = "pressure",
+        .mHandler = coap_pressure_handler,
+        .mContext = NULL,
+        .mNext = NULL,
+};
+#endif
 
-struct sensor_value temperature, humidity, co2, eco2, tvoc;
-struct ccs811_data ccs811;
-struct sps30_measurement m;
-int16_t ret;
+static otCoapResource i2c_stats_resource = {
+        .mUriPath = "i2cstats",
+        .mHandler = coap_i2c_stats_handler,
+        .mContext = NULL,
+        .mNext = NULL,
+};
+static char i2c_stats_json[I2C_STATS_JSON_SIZE];
+#endif
 
-#define I2C_DEV DT_LABEL(DT_ALIAS(i2c0))
-#define I2C_NODE DT_NODELABEL(i2c0)
-#define I2C_DEV_LABEL DT_LABEL(DT_NODELABEL(i2c0))
-#define CCS811_I2C_ADDRESS 0x5A
+static struct sample sample;
+/* The SCD41 delivered a sample in the running acquisition cycle */
+static bool scd41_sample_fresh;
+static atomic_t acquisition_busy;
+/* The registered sensors were put to sleep when sending stopped */
+static bool sensors_suspended;
+/* Registry indexes whose suspend or resume hook is still under way, and
+ * which of the two */
+static uint32_t sensors_power_pending;
+static bool sensors_power_suspending;
 
-int16_t get_serial(int16_t error, int16_t serial_0, int16_t serial_1, int16_t serial_2)
+/* Bus index (i2cN) each sensor is wired to; the CCS811s take theirs from
+ * the devicetree */
+#define SCD41_I2C_BUS 0
+#define SPS30_I2C_BUS 0
+
+#if defined(CONFIG_APP_SENSOR_SCD41) || defined(CONFIG_APP_SENSOR_SPS30)
+/* General call reset for the buses of the Sensirion sensors, sent on the bus
+ * being recovered. */
+static int sensirion_bus_reset(struct i2c_bus *bus)
 {
-        error = scd4x_get_serial_number(&serial_0, &serial_1, &serial_2);
-        return error;
+        int ret = i2c_bus_select(bus->idx);
+
+        if (ret != 0)
+        {
+                return ret;
+        }
+        return sensirion_i2c_general_call_reset();
 }
+#endif
 
-void read_scd41()
+#ifdef CONFIG_APP_SENSOR_SCD41
+enum scd41_init_step
+{
+        SCD41_INIT_WAKE,
+        SCD41_INIT_STOP,
+        SCD41_INIT_REINIT,
+        SCD41_INIT_CONFIGURE,
+        SCD41_INIT_START,
+};
+
+static enum scd41_init_step scd41_init_step;
+
+/* Sensor (re)initialization; runs at startup and again whenever the recovery
+ * layer asks for it, e.g. after the sensor's bus was reset. Wake-up, stop and
+ * reinit take up to 500 ms each, so every one is a step of its own: the
+ * registry calls this again after ms_until_ready while it returns -EAGAIN. */
+static int16_t init_scd41(const struct app_sensor *sensor)
+{
+        uint16_t serial_0 = 0;
+        uint16_t serial_1 = 0;
+        uint16_t serial_2 = 0;
+        int16_t error = 0;
+
+        if (scd4x_ms_until_idle() > 0)
+        {
+                return -EAGAIN;
+        }
+
+        switch (scd41_init_step)
+        {
+        case SCD41_INIT_WAKE:
+                scd4x_wake_up();
+                break;
+        case SCD41_INIT_STOP:
+                scd4x_stop_periodic_measurement();
+                break;
+        case SCD41_INIT_REINIT:
+                scd4x_reinit();
+                break;
+        case SCD41_INIT_CONFIGURE:
+                error = scd4x_get_serial_number(&serial_0, &serial_1, &serial_2);
+                if (error)
+                {
+                        printk("Error executing scd4x_get_serial_number(): %i\n", error);
+                        break;
+                }
+                printk("serial: 0x%04x%04x%04x\n", serial_0, serial_1, serial_2);
+
+                /* altitude until an ambient pressure comes in; set while idle */
+                error = scd4x_pressure_start(CONFIG_APP_SCD41_ALTITUDE_M,
+                                             CONFIG_APP_SCD41_PRESSURE_STEP_HPA * 100);
+                if (error)
+                {
+                        printk("Error executing scd4x_pressure_start(): %i\n", error);
+                }
+                break;
+        default:
+                /* cheapest measurement mode for the reporting interval */
+                error = scd4x_power_start(DATA_SENDING_INTERVAL);
+                if (error == -EAGAIN)
+                {
+                        return error;
+                }
+                if (error)
+                {
+                        printk("Error executing scd4x_power_start(): %i\n", error);
+                }
+                scd41_init_step = SCD41_INIT_WAKE;
+                return error;
+        }
+
+        /* a failed step starts the sequence over with the next attempt */
+        scd41_init_step = error ? SCD41_INIT_WAKE : scd41_init_step + 1;
+        return error ? error : -EAGAIN;
+}
+
+#if DT_NODE_HAS_STATUS(BAROMETER_NODE, okay)
+static const struct device *const barometer = DEVICE_DT_GET(BAROMETER_NODE);
+
+/* The barometer has its own Zephyr driver and is read outside the recovery
+ * layer; a failed read keeps the last pressure. */
+static void read_barometer(void)
+{
+        struct sensor_value press;
+
+        if (!device_is_ready(barometer) || sensor_sample_fetch_chan(barometer, SENSOR_CHAN_PRESS) != 0 ||
+            sensor_channel_get(barometer, SENSOR_CHAN_PRESS, &press) != 0)
+        {
+                printk("Failed to read the barometer\n");
+                return;
+        }
+        /* kPa */
+        if (scd4x_pressure_set(press.val1 * 1000 + press.val2 / 1000) != 0)
+        {
+                printk("Barometer out of range: %d.%06d kPa\n", press.val1, press.val2);
+        }
+}
+#endif
+
+static int16_t read_scd41(const struct app_sensor *sensor)
 {
         int16_t error;
-        bool data_ready_flag = false;
-        error = scd4x_get_data_ready_flag(&data_ready_flag);
+
+        /* A changed pressure goes in ahead of the sample it is meant for. A
+         * powered down sensor gets it with the next read after its wake-up. */
+        if (scd4x_power_awake())
+        {
+                error = scd4x_pressure_update();
+                if (error)
+                {
+                        printk("Error executing scd4x_pressure_update(): %i\n", error);
+                        return error;
+                }
+        }
+        error = scd4x_power_read(&sample.co2, &sample.temperature, &sample.humidity);
+        if (error == -EAGAIN)
+        {
+                return error;
+        }
         if (error)
         {
-                printf("Error executing scd4x_get_data_ready_flag(): %i\n", error);
-                return;
+                printk("Error executing scd4x_power_read(): %i\n", error);
+                return error;
         }
-        if (!data_ready_flag)
+        else if (sample.co2 == 0)
         {
-                return;
+                printk("Invalid sample detected, skipping.\n");
+        }
+        else
+        {
+                scd41_sample_fresh = true;
+        }
+#if DT_NODE_HAS_STATUS(BAROMETER_NODE, okay)
+        /* for the next sample */
+        read_barometer();
+#endif
+        return 0;
+}
+
+static int32_t ms_until_ready_scd41(const struct app_sensor *sensor)
+{
+        return scd4x_power_ms_until_ready();
+}
+
+static int16_t suspend_scd41(const struct app_sensor *sensor)
+{
+        return scd4x_power_suspend();
+}
+
+static int16_t resume_scd41(const struct app_sensor *sensor)
+{
+        return scd4x_power_resume();
+}
+
+static const struct app_sensor scd41_sensor = {
+        .name = "SCD41",
+        .bus = SCD41_I2C_BUS,
+        .addr = SCD4X_I2C_ADDRESS,
+        .channels = SENSOR_REGISTRY_CH_CO2 | SENSOR_REGISTRY_CH_TEMPERATURE | SENSOR_REGISTRY_CH_HUMIDITY,
+        .min_period_ms = SCD4X_PERIODIC_INTERVAL_MS,
+        /* command and 9 byte read at 100 kHz, plus the 1 ms execution time */
+        .read_cost_us = 2200,
+        .init = init_scd41,
+        .read = read_scd41,
+        .ms_until_ready = ms_until_ready_scd41,
+        .suspend = suspend_scd41,
+        .resume = resume_scd41,
+};
+#endif
+
+#ifdef CONFIG_APP_SENSOR_CCS811
+/* The CCS811s are the "ams,ccs811-app" devicetree nodes; the report carries
+ * the mean of those with a result. */
+#define CCS811_COUNT DT_NUM_INST_STATUS_OKAY(ams_ccs811_app)
+
+struct ccs811_instance
+{
+        struct app_sensor sensor;
+        const struct device *dev;
+        bool irq; /* results are signalled by the data ready trigger */
+        /* Last result, read when nINT or the status reports a new one */
+        uint16_t eco2;
+        uint16_t tvoc;
+        bool has_result;
+        bool fresh; /* not reported yet */
+        /* Compensation last written to the sensor */
+        bool env_set;
+        int32_t env_temperature;
+        int32_t env_humidity;
+        struct k_work irq_work;
+        struct k_work_delayable baseline_work;
+};
+
+#define CCS811_INSTANCE(i, _) {.dev = DEVICE_DT_GET(DT_INST(i, ams_ccs811_app))}
+
+static struct ccs811_instance ccs811s[CCS811_COUNT] = {LISTIFY(CCS811_COUNT, CCS811_INSTANCE, (, ))};
+static const struct sensor_trigger ccs811_trigger = {
+        .type = SENSOR_TRIG_DATA_READY,
+        .chan = SENSOR_CHAN_ALL,
+};
+
+/* The first attempt only starts the firmware; the acquisition comes back
+ * once it booted, like it does for a sensor without a fresh sample. */
+static int16_t init_ccs811(const struct app_sensor *sensor)
+{
+        struct ccs811_instance *ccs = sensor->ctx;
+        int ret;
+
+        ccs->has_result = false;
+        ccs->fresh = false;
+        ccs->env_set = false;
+        ret = ccs811_sensor_start(ccs->dev);
+        if (ret == -EAGAIN)
+        {
+                return -EAGAIN;
+        }
+        if (ret != 0)
+        {
+                printk("Failed to initialize CCS811 0x%02x\n", sensor->addr);
+                return -EIO;
+        }
+        printk("CCS811 0x%02x initialized\n", sensor->addr);
+        ccs811_baseline_start(ccs->dev);
+        return 0;
+}
+
+/* Feeds the SCD41's temperature and humidity into the CCS811 compensation,
+ * only when they moved noticeably, so it costs a bus write now and then. The
+ * sample stays fresh until the last CCS811 got it. */
+static int16_t compensate_ccs811(struct ccs811_instance *ccs)
+{
+        int error;
+
+        if (!scd41_sample_fresh)
+        {
+                return 0;
+        }
+        if (ccs == &ccs811s[CCS811_COUNT - 1])
+        {
+                scd41_sample_fresh = false;
         }
+        if (ccs->env_set && abs(sample.temperature - ccs->env_temperature) < CCS811_ENV_TEMPERATURE_STEP &&
+            abs(sample.humidity - ccs->env_humidity) < CCS811_ENV_HUMIDITY_STEP)
+        {
+                return 0;
+        }
+        error = ccs811_sensor_env_update(ccs->dev, sample.temperature, sample.humidity);
+        if (error)
+        {
+                return error;
+        }
+        ccs->env_set = true;
+        ccs->env_temperature = sample.temperature;
+        ccs->env_humidity = sample.humidity;
+        return 0;
+}
 
-        error = scd4x_read_measurement(&co2, &temperature, &humidity);
+/* One burst of results, status and error; the status tells whether the
+ * result is new, so there is no separate status read. */
+static int16_t fetch_ccs811(const struct app_sensor *sensor)
+{
+        struct ccs811_instance *ccs = sensor->ctx;
+        struct ccs811_result result;
+        struct sensor_value eco2;
+        struct sensor_value tvoc;
+        int error = sensor_sample_fetch(ccs->dev);
+
+        if (error == -ENODATA)
+        {
+                return 0;
+        }
         if (error)
         {
-                printf("Error executing scd4x_read_measurement(): %i\n", error);
-                return;
+                printk("Failed to read CCS811 0x%02x\n", sensor->addr);
+                return error;
+        }
+        ccs811_sensor_result(ccs->dev, &result);
+        if (result.status & CCS811_STATUS_DATA_READY)
+        {
+                sensor_channel_get(ccs->dev, SENSOR_CHAN_CO2, &eco2);
+                sensor_channel_get(ccs->dev, SENSOR_CHAN_VOC, &tvoc);
+                ccs->eco2 = eco2.val1;
+                ccs->tvoc = tvoc.val1;
+                ccs->has_result = true;
+                ccs->fresh = true;
+        }
+        return 0;
+}
+
+/* Reports the mean of the CCS811s that have a result */
+static void ccs811_sample_update(void)
+{
+        uint32_t eco2 = 0;
+        uint32_t tvoc = 0;
+        uint8_t count = 0;
+
+        for (uint8_t i = 0; i < CCS811_COUNT; i++)
+        {
+                if (ccs811s[i].has_result)
+                {
+                        eco2 += ccs811s[i].eco2;
+                        tvoc += ccs811s[i].tvoc;
+                        count++;
+                }
         }
-        else if (sensor_value_to_double(&co2) == 0)
+        if (count != 0)
         {
-                printf("Invalid sample detected, skipping.\n");
+                sample.eco2 = eco2 / count;
+                sample.tvoc = tvoc / count;
         }
 }
 
-void read_ccs811(struct ccs811_data *ccs811)
+/* Compensates with the SCD41 sample of this cycle, then takes the result */
+static int16_t read_ccs811(const struct app_sensor *sensor)
 {
-        if (ccs811_data_ready(ccs811))
+        struct ccs811_instance *ccs = sensor->ctx;
+        int error;
+
+        error = compensate_ccs811(ccs);
+        if (error)
+        {
+                return error;
+        }
+        /* nINT stays asserted after a missed edge or a failed read */
+        if (!ccs->irq || ccs811_sensor_irq_pending(ccs->dev))
         {
-                if (ccs811_read(ccs811, &eco2, &tvoc) == 0)
+                error = fetch_ccs811(sensor);
+                if (error)
                 {
-                        printk("Data read from CCS811\n");
+                        return error;
+                }
+        }
+        /* With the interrupt the result is read when it comes out. Without
+         * it, waiting for the next one in the slow drive modes would outlast
+         * the cycle; the held result is as recent as the mode allows. */
+        if (!ccs->fresh &&
+            (!ccs->has_result ||
+             (!ccs->irq && sensor->min_period_ms <= ACQUISITION_POLL_MS * ACQUISITION_MAX_POLLS)))
+        {
+                return -EAGAIN;
+        }
+        ccs->fresh = false;
+        ccs811_sample_update();
+        printk("Data read from CCS811 0x%02x\n", sensor->addr);
+        return 0;
+}
+
+/* A suspended CCS811 idles in drive mode 0, through the driver's runtime
+ * PM, which prj.conf enables. */
+static int16_t suspend_ccs811(const struct app_sensor *sensor)
+{
+        struct ccs811_instance *ccs = sensor->ctx;
+
+        return pm_device_runtime_put(ccs->dev);
+}
+
+static int16_t resume_ccs811(const struct app_sensor *sensor)
+{
+        struct ccs811_instance *ccs = sensor->ctx;
+
+        return pm_device_runtime_get(ccs->dev);
+}
+
+static int16_t update_ccs811_baseline(const struct app_sensor *sensor)
+{
+        struct ccs811_instance *ccs = sensor->ctx;
+
+        return ccs811_baseline_update(ccs->dev);
+}
+
+/* A new CCS811 result is read as soon as nINT signals it, which also
+ * releases nINT again. */
+static void ccs811_irq_handler(struct k_work *work)
+{
+        struct ccs811_instance *ccs = CONTAINER_OF(work, struct ccs811_instance, irq_work);
+
+        sensor_registry_access(&ccs->sensor, fetch_ccs811);
+}
+
+/* Runs on the system work queue; the bus is only touched from the
+ * acquisition queue. */
+static void ccs811_trigger_handler(const struct device *dev, const struct sensor_trigger *trigger)
+{
+        for (uint8_t i = 0; i < CCS811_COUNT; i++)
+        {
+                if (ccs811s[i].dev == dev)
+                {
+                        k_work_submit_to_queue(&acquisition_work_q, &ccs811s[i].irq_work);
+                }
+        }
+}
+
+/* Restores the stored CCS811 baseline after the run-in and keeps it stored */
+static void ccs811_baseline_handler(struct k_work *work)
+{
+        struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+        struct ccs811_instance *ccs = CONTAINER_OF(dwork, struct ccs811_instance, baseline_work);
+        int32_t delay_ms = CCS811_BASELINE_RETRY_MS;
+
+        if (sensor_registry_access(&ccs->sensor, update_ccs811_baseline) == 0)
+        {
+                delay_ms = ccs811_baseline_ms_until_due(ccs->dev);
+        }
+        if (delay_ms <= 0)
+        {
+                delay_ms = CCS811_BASELINE_RETRY_MS;
+        }
+        k_work_reschedule_for_queue(&acquisition_work_q, dwork, K_MSEC(delay_ms));
+}
+
+/* Fills in the descriptor of every CCS811, with the bus it is on */
+static void ccs811_setup(void)
+{
+        if (ccs811_baseline_init(CONFIG_APP_CCS811_BASELINE_SAVE_HOURS * 3600000U) != 0)
+        {
+                printk("Failed to load the CCS811 baseline\n");
+        }
+        for (uint8_t i = 0; i < CCS811_COUNT; i++)
+        {
+                struct ccs811_instance *ccs = &ccs811s[i];
+                struct i2c_bus *bus = ccs811_sensor_bus(ccs->dev);
+
+                ccs->sensor = (struct app_sensor){
+                        .name = "CCS811",
+                        .addr = ccs811_sensor_addr(ccs->dev),
+                        .channels = SENSOR_REGISTRY_CH_ECO2 | SENSOR_REGISTRY_CH_TVOC,
+                        .min_period_ms = ccs811_sensor_period_ms(ccs->dev),
+                        /* register address and 8 byte burst at 100 kHz */
+                        .read_cost_us = 1000,
+                        .ctx = ccs,
+                        .init = init_ccs811,
+                        .read = read_ccs811,
+                        .suspend = suspend_ccs811,
+                        .resume = resume_ccs811,
+                };
+                if (!device_is_ready(ccs->dev) || bus == NULL)
+                {
+                        printk("No I2C bus for CCS811 0x%02x\n", ccs->sensor.addr);
                 }
                 else
                 {
-                        printk("Failed to read CCS811 sensor data\n");
+                        ccs->sensor.bus = bus->idx;
                 }
+                i2c_recovery_register(ccs->sensor.bus, ccs->sensor.addr, NULL);
+                k_work_init(&ccs->irq_work, ccs811_irq_handler);
+                k_work_init_delayable(&ccs->baseline_work, ccs811_baseline_handler);
+                /* measure from the start */
+                pm_device_runtime_get(ccs->dev);
+                ccs->irq = sensor_trigger_set(ccs->dev, &ccs811_trigger, ccs811_trigger_handler) == 0;
+                sensor_registry_add(&ccs->sensor);
         }
-        else
+}
+
+/* Once the acquisition queue runs */
+static void ccs811_start(void)
+{
+        for (uint8_t i = 0; i < CCS811_COUNT; i++)
+        {
+                k_work_reschedule_for_queue(&acquisition_work_q, &ccs811s[i].baseline_work,
+                                            K_MSEC(ccs811_baseline_ms_until_due(ccs811s[i].dev)));
+        }
+}
+#endif
+
+#ifdef CONFIG_APP_SENSOR_SPS30
+static bool sps30_woken;
+
+/* The wake-up takes 5 ms, so the probe follows in a second step. */
+static int16_t init_sps30(const struct app_sensor *sensor)
+{
+        char serial[SPS30_MAX_SERIAL_LEN];
+        int16_t error;
+
+        if (sps30_ms_until_idle() > 0)
+        {
+                return -EAGAIN;
+        }
+        if (!sps30_woken)
+        {
+                /* not acknowledged unless the sensor sleeps */
+                (void)sps30_wake_up();
+                sps30_woken = true;
+                return -EAGAIN;
+        }
+        sps30_woken = false;
+
+        error = sps30_get_serial(serial);
+        if (error)
+        {
+                printk("SPS30 sensor probing failed\n");
+                return error;
+        }
+        printk("SPS sensor probing successful\n");
+
+        error = sps30_health_start();
+        if (error)
+        {
+                printk("Error reading SPS30 firmware version\n");
+                return error;
+        }
+
+#ifndef CONFIG_APP_SPS30_READ_SIZE_DISTRIBUTION
+        /* mass concentrations only, the read stops after them */
+        sps30_set_read_fields(SPS30_FIELDS_MASS);
+#endif
+
+        /* sleeps between reports unless the interval is too short */
+        error = sps30_duty_start(DATA_SENDING_INTERVAL, CONFIG_APP_SPS30_SPINUP_MS,
+                                 CONFIG_APP_SPS30_AVERAGE_SAMPLES);
+        if (error)
+        {
+                printk("Error starting measurement\n");
+        }
+        return error;
+}
+
+static int16_t wake_sps30(const struct app_sensor *sensor)
+{
+        return sps30_duty_wake();
+}
+
+static const struct app_sensor sps30_sensor;
+
+/* Wakes the SPS30 one spin-up time ahead of the next report, a step at a
+ * time. */
+static void sps30_wake_handler(struct k_work *work)
+{
+        if (sensor_registry_access(&sps30_sensor, wake_sps30) == -EAGAIN)
+        {
+                k_work_reschedule_for_queue(&acquisition_work_q, k_work_delayable_from_work(work),
+                                            K_MSEC(MAX(sps30_duty_ms_until_ready(), 1)));
+        }
+}
+
+K_WORK_DELAYABLE_DEFINE(sps30_wake_work, sps30_wake_handler);
+
+/* Cleanings are only started while no report is near, so they never spoil a
+ * reading; a duty-cycled sensor runs them in its spin-up instead. */
+static bool sps30_quiet(void)
+{
+        uint32_t needed_ms = SPS30_HEALTH_CLEAN_MS + SPS30_HEALTH_CLEAN_SETTLE_MS;
+
+        if (atomic_get(&acquisition_busy))
         {
-                printk("CCS811 data not ready\n");
+                return false;
         }
+        return !function_running || k_timer_remaining_get(&send_timer) > needed_ms;
 }
 
-void read_sps30()
+static int16_t check_sps30_health(const struct app_sensor *sensor)
 {
-        sensirion_sleep_usec(SPS30_MEASUREMENT_DURATION_USEC);
-        ret = sps30_read_measurement(&m);
-        if (ret < 0)
+        int16_t error;
+
+        /* the fan is off while the sensor sleeps */
+        if (!sps30_duty_awake())
+        {
+                return 0;
+        }
+        if (sps30_ms_until_idle() > 0)
+        {
+                return -EAGAIN;
+        }
+        error = sps30_health_check();
+        if (error)
+        {
+                printk("Error reading SPS30 status: %i\n", error);
+                return error;
+        }
+        if (!sps30_health_reading_valid())
+        {
+                printk("SPS30 health: %s, status 0x%08x\n", sps30_health_state_str(sps30_health_state()),
+                       sps30_health_status());
+        }
+        if (sps30_health_clean_wanted() && sps30_duty_ms_until_wake() < 0 && sps30_quiet())
+        {
+                printk("Cleaning SPS30 fan\n");
+                error = sps30_health_clean();
+        }
+        return error;
+}
+
+static void sps30_health_handler(struct k_work *work)
+{
+        if (sensor_registry_access(&sps30_sensor, check_sps30_health) == -EAGAIN)
+        {
+                k_work_reschedule_for_queue(&acquisition_work_q, k_work_delayable_from_work(work),
+                                            K_MSEC(MAX(sps30_ms_until_idle(), 1)));
+        }
+}
+
+K_WORK_DELAYABLE_DEFINE(sps30_health_work, sps30_health_handler);
+
+static int16_t read_sps30(const struct app_sensor *sensor)
+{
+        int32_t sleep_ms;
+        int16_t ret;
+
+        ret = sps30_duty_read(&sample.pm);
+        if (ret == -EAGAIN)
+        {
+                return ret;
+        }
+        if (ret)
         {
                 printk("Error reading measurement\n");
+                return ret;
         }
         else
         {
+                sample.pm_health = sps30_health_state();
+                sample.pm_status = sps30_health_status();
+                sample.pm_valid = sps30_health_reading_valid();
                 printk("SPS30:\n"
-                       "PM1.0: %0.2f ug/m3\n"
-                       "PM2.5: %0.2f ug/m3\n"
-                       "PM4.0: %0.2f ug/m3\n"
-                       "PM10: %0.2f ug/m3\n"
-                       "NC0.5: %0.2f #/cm3\n"
-                       "NC1.0: %0.2f #/cm3\n"
-                       "NC2.5: %0.2f #/cm3\n"
-                       "NC4.0: %0.2f #/cm3\n"
-                       "NC10: %0.2f #/cm3\n"
-                       "Typical Particle Size: %0.2f um\n\n",
-                       m.mc_1p0, m.mc_2p5, m.mc_4p0, m.mc_10p0, m.nc_0p5, m.nc_1p0,
-                       m.nc_2p5, m.nc_4p0, m.nc_10p0, m.typical_particle_size);
+                       "PM1.0: %u ng/m3\n"
+                       "PM2.5: %u ng/m3\n"
+                       "PM4.0: %u ng/m3\n"
+                       "PM10: %u ng/m3\n"
+                       "NC0.5: %u #/dm3\n"
+                       "NC1.0: %u #/dm3\n"
+                       "NC2.5: %u #/dm3\n"
+                       "NC4.0: %u #/dm3\n"
+                       "NC10: %u #/dm3\n"
+                       "Typical Particle Size: %u nm\n\n",
+                       sample.pm.mc_1p0, sample.pm.mc_2p5, sample.pm.mc_4p0, sample.pm.mc_10p0,
+                       sample.pm.nc_0p5, sample.pm.nc_1p0, sample.pm.nc_2p5, sample.pm.nc_4p0,
+                       sample.pm.nc_10p0, sample.pm.typical_particle_size);
+
+                sleep_ms = sps30_duty_ms_until_wake();
+                if (sleep_ms >= 0)
+                {
+                        k_work_reschedule_for_queue(&acquisition_work_q, &sps30_wake_work, K_MSEC(sleep_ms));
+                        /* the fan is up to speed and a cleaning over by then */
+                        sleep_ms += MAX(CONFIG_APP_SPS30_SPINUP_MS - SPS30_HEALTH_CHECK_LEAD_MS, 0);
+                }
+                else
+                {
+                        /* halfway between two reports */
+                        sleep_ms = DATA_SENDING_INTERVAL / 2;
+                }
+                k_work_reschedule_for_queue(&acquisition_work_q, &sps30_health_work, K_MSEC(sleep_ms));
         }
+        return ret;
+}
+
+static int32_t ms_until_ready_sps30(const struct app_sensor *sensor)
+{
+        return sps30_duty_ms_until_ready();
+}
+
+/* Nothing wakes a suspended SPS30 until the next read */
+static int16_t suspend_sps30(const struct app_sensor *sensor)
+{
+        k_work_cancel_delayable(&sps30_wake_work);
+        k_work_cancel_delayable(&sps30_health_work);
+        return sps30_duty_suspend();
+}
+
+static int16_t resume_sps30(const struct app_sensor *sensor)
+{
+        return sps30_duty_resume();
 }
 
+static const struct app_sensor sps30_sensor = {
+        .name = "SPS30",
+        .bus = SPS30_I2C_BUS,
+        .addr = SPS30_I2C_ADDRESS,
+        .channels = SENSOR_REGISTRY_CH_PM,
+        .min_period_ms = SPS30_MEASUREMENT_INTERVAL_MS,
+        /* command and integer read at 100 kHz */
+#ifdef CONFIG_APP_SPS30_READ_SIZE_DISTRIBUTION
+        .read_cost_us = 3100,
+#else
+        .read_cost_us = 1500,
+#endif
+        .init = init_sps30,
+        .read = read_sps30,
+        .ms_until_ready = ms_until_ready_sps30,
+        .suspend = suspend_sps30,
+        .resume = resume_sps30,
+};
+#endif
+
+static uint8_t acquisition_sensor_idx;
+static uint8_t acquisition_polls;
+
+K_WORK_DEFINE(coap_work, coap_send_data_request);
+K_WORK_DELAYABLE_DEFINE(acquisition_work, acquire_sensor_data);
+
+/* Runs on the acquisition work queue so bus transfers never hold up the system
+ * work queue; the CoAP request is handed back to it once fresh samples are
+ * available. Each run reads one registered sensor. A sensor without a fresh
+ * sample is polled again from a timer, so the thread is free while waiting
+ * and only spends the actual bus time per read. */
+static void acquire_sensor_data(struct k_work *work)
+{
+        const struct app_sensor *sensor = sensor_registry_get(acquisition_sensor_idx);
+        int32_t wait_ms = 0;
+
+        if (sensor != NULL && sensor_registry_access(sensor, sensor->read) == -EAGAIN &&
+            ++acquisition_polls < ACQUISITION_MAX_POLLS)
+        {
+                if (sensor->ms_until_ready != NULL)
+                {
+                        wait_ms = sensor->ms_until_ready(sensor);
+                }
+                if (wait_ms <= 0)
+                {
+                        wait_ms = ACQUISITION_POLL_MS;
+                }
+                k_work_reschedule_for_queue(&acquisition_work_q, &acquisition_work, K_MSEC(wait_ms));
+                return;
+        }
+
+        acquisition_polls = 0;
+        if (++acquisition_sensor_idx < sensor_registry_count())
+        {
+                k_work_reschedule_for_queue(&acquisition_work_q, &acquisition_work, K_NO_WAIT);
+                return;
+        }
+
+        acquisition_sensor_idx = 0;
+        atomic_clear(&acquisition_busy);
+        k_work_submit(&coap_work);
+}
+
+/* Puts the sensors to sleep while nothing is sent and wakes them when
+ * sending starts again. A running cycle is finished first. */
+static void sensors_power_handler(struct k_work *work)
+{
+        bool suspend = !function_running;
+        int32_t wait_ms = 0;
+
+        if (sensors_power_pending == 0 && suspend == sensors_suspended)
+        {
+                return;
+        }
+        if (suspend && atomic_get(&acquisition_busy))
+        {
+                k_work_reschedule_for_queue(&acquisition_work_q, k_work_delayable_from_work(work),
+                                            K_MSEC(ACQUISITION_POLL_MS));
+                return;
+        }
+        /* The hooks go a step at a time: a sensor whose hook returned
+         * -EAGAIN is run again once it can make progress, each of the others
+         * ran exactly once. A change of mind halfway starts over. */
+        if (sensors_power_pending == 0 || suspend != sensors_power_suspending)
+        {
+                sensors_power_pending = BIT_MASK(sensor_registry_count());
+                sensors_power_suspending = suspend;
+        }
+        for (uint8_t i = 0; i < sensor_registry_count(); i++)
+        {
+                const struct app_sensor *sensor = sensor_registry_get(i);
+                app_sensor_op_t op = suspend ? sensor->suspend : sensor->resume;
+                int16_t error = 0;
+
+                if (!(sensors_power_pending & BIT(i)))
+                {
+                        continue;
+                }
+                if (op != NULL)
+                {
+                        error = sensor_registry_access(sensor, op);
+                }
+                if (error == -EAGAIN)
+                {
+                        if (sensor->ms_until_ready != NULL)
+                        {
+                                wait_ms = MAX(wait_ms, sensor->ms_until_ready(sensor));
+                        }
+                        continue;
+                }
+                sensors_power_pending &= ~BIT(i);
+                if (error != 0)
+                {
+                        printk("Failed to %s %s 0x%02x\n", suspend ? "suspend" : "resume", sensor->name,
+                               sensor->addr);
+                }
+        }
+        if (sensors_power_pending != 0)
+        {
+                k_work_reschedule_for_queue(&acquisition_work_q, k_work_delayable_from_work(work),
+                                            K_MSEC(MAX(wait_ms, 1)));
+                return;
+        }
+        sensors_suspended = suspend;
+}
+
+K_WORK_DELAYABLE_DEFINE(sensors_power_work, sensors_power_handler);
+
+/* Registers the sensors in the order they are read: the SCD41 first, whose
+ * temperature and humidity compensate the CCS811s. */
+static void sensors_register(void)
+{
+#ifdef CONFIG_APP_SENSOR_SCD41
+        sensor_registry_add(&scd41_sensor);
+#endif
+#ifdef CONFIG_APP_SENSOR_CCS811
+        ccs811_setup();
+#endif
+#ifdef CONFIG_APP_SENSOR_SPS30
+        sensor_registry_add(&sps30_sensor);
+#endif
+
+        for (uint8_t i = 0; i < sensor_registry_count(); i++)
+        {
+                const struct app_sensor *sensor = sensor_registry_get(i);
+
+                if (sensor->min_period_ms > DATA_SENDING_INTERVAL)
+                {
+                        printk("%s 0x%02x delivers a sample every %u ms only\n", sensor->name, sensor->addr,
+                               sensor->min_period_ms);
+                }
+        }
+        printk("%u sensors, channels 0x%02x, %u us bus time per cycle\n", sensor_registry_count(),
+               sensor_registry_channels(), sensor_registry_read_cost_us());
+}
+
+static void format_sensors_data(void)
+{
+        sample_to_json(&sample, sensors_data, sizeof(sensors_data));
+}
+
+#if defined(CONFIG_OPENTHREAD_COAP)
 static void coap_send_data_request(struct k_work *work)
 {
         // char sensors_data[160];
@@ -140,10 +965,6 @@ static void coap_send_data_request(struct k_work *work)
 
         do
         {
-                read_scd41();
-                read_ccs811(&ccs811);
-                read_sps30();
-
                 myMessage = otCoapNewMessage(myInstance, NULL);
                 if (myMessage == NULL)
                 {
@@ -166,19 +987,7 @@ static void coap_send_data_request(struct k_work *work)
                 {
                         break;
                 }
-                // printk("%.2f", sensor_value_to_double(&tvoc));
-                const double calculated_humidity = sensor_value_to_double(&humidity) / 1000.0;
-                const double calculated_temperature = sensor_value_to_double(&temperature) / 1000.0;
-                snprintf(sensors_data, sizeof(sensors_data),
-                         "{\"CO\":%.2f,\"Hm\":%.2f,\"Tp\":%.2f,\"eCO\":%.2f,\"1p0\":%.2f,\"2p5\":%.2f,\"4p0\":%.2f,\"10p0\":%.2f,\"ps\":%.2f,\"tv\":%.2f}",
-                         sensor_value_to_double(&co2),
-                         calculated_humidity,
-                         calculated_temperature,
-                         sensor_value_to_double(&eco2),
-                         m.mc_1p0,
-                         m.mc_2p5, m.mc_4p0, m.mc_10p0, m.typical_particle_size, sensor_value_to_double(&tvoc));
-                //  sensor_value_to_double(&tvoc),
-                sensors_data[159] = '\0';
+                format_sensors_data();
 
                 error = otMessageAppend(myMessage, sensors_data, strlen(sensors_data));
                 if (error != OT_ERROR_NONE)
@@ -211,8 +1020,6 @@ static void coap_send_data_request(struct k_work *work)
         // free(sensors_data);
 }
 
-K_WORK_DEFINE(sensor_work, coap_send_data_request);
-
 static void coap_send_data_response_cb(void *p_context, otMessage *p_message, const otMessageInfo *p_message_info, otError result)
 {
         if (result == OT_ERROR_NONE)
@@ -225,6 +1032,123 @@ static void coap_send_data_response_cb(void *p_context, otMessage *p_message, co
         }
 }
 
+/* GET coap://<node>/i2cstats returns the per-device I2C bus counters */
+static void coap_i2c_stats_handler(void *p_context, otMessage *p_message, const otMessageInfo *p_message_info)
+{
+        otError error = OT_ERROR_NONE;
+        otMessage *response;
+        otInstance *myInstance = openthread_get_default_instance();
+        int len;
+
+        if (otCoapMessageGetType(p_message) != OT_COAP_TYPE_CONFIRMABLE ||
+            otCoapMessageGetCode(p_message) != OT_COAP_CODE_GET)
+        {
+                return;
+        }
+
+        response = otCoapNewMessage(myInstance, NULL);
+        if (response == NULL)
+        {
+                printk("Failed to allocate message for CoAP Response\n");
+                return;
+        }
+
+        do
+        {
+                error = otCoapMessageInitResponse(response, p_message, OT_COAP_TYPE_ACKNOWLEDGMENT, OT_COAP_CODE_CONTENT);
+                if (error != OT_ERROR_NONE)
+                {
+                        break;
+                }
+                error = otCoapMessageAppendContentFormatOption(response, OT_COAP_OPTION_CONTENT_FORMAT_JSON);
+                if (error != OT_ERROR_NONE)
+                {
+                        break;
+                }
+                error = otCoapMessageSetPayloadMarker(response);
+                if (error != OT_ERROR_NONE)
+                {
+                        break;
+                }
+                len = i2c_stats_to_json(i2c_stats_json, sizeof(i2c_stats_json));
+                if (len < 0)
+                {
+                        error = OT_ERROR_NO_BUFS;
+                        break;
+                }
+                error = otMessageAppend(response, i2c_stats_json, len);
+                if (error != OT_ERROR_NONE)
+                {
+                        break;
+                }
+                error = otCoapSendResponse(myInstance, response, p_message_info);
+        } while (false);
+
+        if (error != OT_ERROR_NONE)
+        {
+                printk("Failed to send I2C statistics: %d\n", error);
+                otMessageFree(response);
+        }
+}
+
+#if defined(CONFIG_APP_SENSOR_SCD41)
+/* PUT coap://<node>/pressure with the ambient pressure in Pa as payload, e.g.
+ * from a barometer of the border router; used for the SCD41 compensation. */
+static void coap_pressure_handler(void *p_context, otMessage *p_message, const otMessageInfo *p_message_info)
+{
+        otError error = OT_ERROR_NONE;
+        otMessage *response;
+        otInstance *myInstance = openthread_get_default_instance();
+        otCoapCode code = OT_COAP_CODE_CHANGED;
+        char payload[8];
+        char *end;
+        uint16_t len;
+        unsigned long pressure_pa;
+
+        if (otCoapMessageGetType(p_message) != OT_COAP_TYPE_CONFIRMABLE ||
+            otCoapMessageGetCode(p_message) != OT_COAP_CODE_PUT)
+        {
+                return;
+        }
+
+        /* Decimal Pa only: an empty, oversized or partly numeric payload is
+         * refused rather than truncated */
+        len = otMessageGetLength(p_message) - otMessageGetOffset(p_message);
+        if (len == 0 || len >= sizeof(payload))
+        {
+                code = OT_COAP_CODE_BAD_REQUEST;
+        }
+        else
+        {
+                otMessageRead(p_message, otMessageGetOffset(p_message), payload, len);
+                payload[len] = '\0';
+                pressure_pa = strtoul(payload, &end, 10);
+                if (payload[0] < '0' || payload[0] > '9' || end != payload + len ||
+                    scd4x_pressure_set(pressure_pa) != 0)
+                {
+                        code = OT_COAP_CODE_BAD_REQUEST;
+                }
+        }
+
+        response = otCoapNewMessage(myInstance, NULL);
+        if (response == NULL)
+        {
+                printk("Failed to allocate message for CoAP Response\n");
+                return;
+        }
+        error = otCoapMessageInitResponse(response, p_message, OT_COAP_TYPE_ACKNOWLEDGMENT, code);
+        if (error == OT_ERROR_NONE)
+        {
+                error = otCoapSendResponse(myInstance, response, p_message_info);
+        }
+        if (error != OT_ERROR_NONE)
+        {
+                printk("Failed to answer the pressure update: %d\n", error);
+                otMessageFree(response);
+        }
+}
+#endif
+
 void coap_init()
 {
         otInstance *p_instance = openthread_get_default_instance();
@@ -233,14 +1157,33 @@ void coap_init()
                 printk("Failed to start Coap: %d\n", error);
         else
                 printk("COAP init success!\n");
+
+        otCoapAddResource(p_instance, &i2c_stats_resource);
+#if defined(CONFIG_APP_SENSOR_SCD41)
+        otCoapAddResource(p_instance, &pressure_resource);
+#endif
+}
+#else
+/* Without a Thread network (e.g. on native_sim) the payload is printed */
+static void coap_send_data_request(struct k_work *work)
+{
+        format_sensors_data();
+        printk("Payload: %s\n", sensors_data);
+        memset(sensors_data, 0, sizeof(sensors_data));
 }
 
+void coap_init()
+{
+}
+#endif
+
 void button_pressed_cb(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
         if (pins & BIT(button0_spec.pin))
         {
                 function_running = true;
                 printk("Start sending data....\n");
+                k_work_reschedule_for_queue(&acquisition_work_q, &sensors_power_work, K_NO_WAIT);
                 k_timer_start(&send_timer, K_NO_WAIT, K_MSEC(DATA_SENDING_INTERVAL));
         }
         else if (pins & BIT(button1_spec.pin))
@@ -248,6 +1191,7 @@ void button_pressed_cb(const struct device *dev, struct gpio_callback *cb, uint3
                 function_running = false;
                 printk("Stop sending data....\n");
                 k_timer_stop(&send_timer);
+                k_work_reschedule_for_queue(&acquisition_work_q, &sensors_power_work, K_NO_WAIT);
         }
 }
 
@@ -256,68 +1200,43 @@ void send_timer_callback(struct k_timer *timer_id)
         if (function_running)
         {
                 printk("Submitting worker.\n");
-                k_work_submit(&sensor_work);
+                if (atomic_cas(&acquisition_busy, 0, 1))
+                {
+                        k_work_reschedule_for_queue(&acquisition_work_q, &acquisition_work, K_NO_WAIT);
+                }
         }
 }
 
 int main(void)
 {
-        printk("Initializing SCD41\n");
-        int16_t error = 0;
         sensirion_i2c_hal_init();
-        scd4x_wake_up();
-        scd4x_stop_periodic_measurement();
-        scd4x_reinit();
-
-        uint16_t serial_0 = 0;
-        uint16_t serial_1 = 0;
-        uint16_t serial_2 = 0;
-
-        error = get_serial(error, serial_0, serial_1, serial_2);
-        if (error)
-        {
-                printk("Error executing scd4x_get_serial_number(): %i\n", error);
-        }
-        else
-        {
-                printk("serial: 0x%04x%04x%04x\n", serial_0, serial_1, serial_2);
-        }
-
-        error = scd4x_start_periodic_measurement();
-        if (error)
-        {
-                printk("Error executing scd4x_start_periodic_measurement(): %i\n", error);
-        }
-
-        printk("Initializing CCS811\n");
-
-        static const struct device *i2c_dev = DEVICE_DT_GET(I2C_NODE);
-
+#ifdef CONFIG_APP_SENSOR_SPS30
         sensirion_i2c_init();
+#endif
+#ifdef CONFIG_APP_SENSOR_SCD41
+        i2c_recovery_register(SCD41_I2C_BUS, SCD4X_I2C_ADDRESS, sensirion_bus_reset);
+#endif
+#ifdef CONFIG_APP_SENSOR_SPS30
+        i2c_recovery_register(SPS30_I2C_BUS, SPS30_I2C_ADDRESS, sensirion_bus_reset);
+#endif
+        sensors_register();
 
-        if (i2c_dev == NULL)
+        /* One attempt each; absent sensors are initialized later by the
+         * acquisition cycle once they respond. */
+        for (uint8_t i = 0; i < sensor_registry_count(); i++)
         {
-                printk("Failed to get I2C device\n");
-                return -1;
-        }
-        printk("I2C device found\n");
+                const struct app_sensor *sensor = sensor_registry_get(i);
 
-        if (ccs811_init(&ccs811, i2c_dev, CCS811_I2C_ADDRESS) != 0)
-        {
-                printk("Failed to initialize CCS811 sensor\n");
+                printk("Initializing %s 0x%02x\n", sensor->name, sensor->addr);
+                sensor_registry_access(sensor, NULL);
         }
-        printk("CCS811 initialized\n");
 
-        while (sps30_probe() != 0)
-        {
-                printk("SPS30 sensor probing failed\n");
-                k_sleep(K_SECONDS(1));
-        }
-        printk("SPS sensor probing successful\n");
-
-        ret = sps30_start_measurement();
-        if (ret < 0)
-                printk("Error starting measurement\n");
+        k_work_queue_start(&acquisition_work_q, acquisition_stack,
+                           K_THREAD_STACK_SIZEOF(acquisition_stack),
+                           ACQUISITION_PRIORITY, NULL);
+#ifdef CONFIG_APP_SENSOR_CCS811
+        ccs811_start();
+#endif
 
         printk("Initializing COAP\n");
         coap_init();
@@ -332,6 +1251,12 @@ int main(void)
 
         printk("Setting timer.\n");
         k_timer_init(&send_timer, send_timer_callback, NULL);
+        if (IS_ENABLED(CONFIG_APP_AUTOSTART))
+        {
+                function_running = true;
+                printk("Start sending data....\n");
+                k_timer_start(&send_timer, K_NO_WAIT, K_MSEC(DATA_SENDING_INTERVAL));
+        }
 
         while (1)
         {
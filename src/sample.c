@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include <zephyr/sys/util.h>
+#include "sample.h"
+
+struct sample_field
+{
+        const char *key;
+        int32_t milli;
+};
+
+int sample_to_json(const struct sample *sample, char *buf, size_t len)
+{
+        const struct sample_field fields[] = {
+                {"CO", sample->co2 * 1000},
+                {"Hm", sample->humidity},
+                {"Tp", sample->temperature},
+                {"eCO", sample->eco2 * 1000},
+                {"1p0", sample->pm.mc_1p0},
+                {"2p5", sample->pm.mc_2p5},
+                {"4p0", sample->pm.mc_4p0},
+                {"10p0", sample->pm.mc_10p0},
+#if !defined(CONFIG_APP_SENSOR_SPS30) || defined(CONFIG_APP_SPS30_READ_SIZE_DISTRIBUTION)
+                /* typical particle size in um; left out when the SPS30 read
+                 * stops before it rather than sent as 0 */
+                {"ps", sample->pm.typical_particle_size},
+#endif
+                {"tv", sample->tvoc * 1000},
+        };
+        /* the SPS30 driver is not built on boards without the sensor */
+        const char *pm_health = "unknown";
+        size_t pos = 0;
+        int ret;
+
+        for (size_t i = 0; i < ARRAY_SIZE(fields); i++)
+        {
+                int32_t milli = fields[i].milli;
+                /* round half away from zero to hundredths */
+                uint32_t centi = ((milli < 0 ? -(uint32_t)milli : (uint32_t)milli) + 5) / 10;
+
+                ret = snprintf(buf + pos, len > pos ? len - pos : 0, "%s\"%s\":%s%u.%02u",
+                               i == 0 ? "{" : ",", fields[i].key, milli < 0 && centi != 0 ? "-" : "",
+                               (unsigned int)(centi / 100), (unsigned int)(centi % 100));
+                if (ret < 0)
+                {
+                        return ret;
+                }
+                pos += ret;
+        }
+#ifdef CONFIG_APP_SENSOR_SPS30
+        pm_health = sps30_health_state_str(sample->pm_health);
+#endif
+        ret = snprintf(buf + pos, len > pos ? len - pos : 0, ",\"pv\":%u,\"ph\":\"%s\",\"pst\":%u}",
+                       sample->pm_valid ? 1U : 0U, pm_health,
+                       (unsigned int)sample->pm_status);
+        return ret < 0 ? ret : (int)(pos + ret);
+}
@@ -0,0 +1,39 @@
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "../sensors/sps30/sps30_health.h"
+
+/**
+ * Readings of one acquisition cycle in integer units. The drivers write
+ * straight into the members and the record is encoded as is, without any
+ * floating point. Members are ordered by size, so there is no padding
+ * between them and member pointers stay naturally aligned.
+ */
+struct sample
+{
+        struct sps30_measurement_milli pm;
+        int32_t temperature; /* m°C */
+        int32_t humidity;    /* m%RH */
+        uint32_t pm_status;  /* SPS30 device status register */
+        uint16_t co2;        /* ppm */
+        uint16_t eco2;       /* ppm */
+        uint16_t tvoc;       /* ppb */
+        uint8_t pm_health;   /* enum sps30_health_state of the PM reading */
+        bool pm_valid;
+};
+
+/**
+ * Encode a sample as the JSON payload sent to the server, every value as a
+ * decimal with two places, followed by the SPS30 health: "pv" 1 if the PM
+ * values can be used, "ph" the health state and "pst" the status register.
+ * The typical particle size "ps" is only part of it if the SPS30 reads it,
+ * see CONFIG_APP_SPS30_READ_SIZE_DISTRIBUTION.
+ *
+ * @returns the length of the payload as snprintf() does
+ */
+int sample_to_json(const struct sample *sample, char *buf, size_t len);
+
+#endif
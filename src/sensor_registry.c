@@ -0,0 +1,83 @@
+#include <errno.h>
+#include <stddef.h>
+#include "../sensors/i2c/i2c_bus.h"
+#include "../sensors/i2c/i2c_recovery.h"
+#include "sensor_registry.h"
+
+static const struct app_sensor *sensor_registry[SENSOR_REGISTRY_MAX];
+static uint8_t sensor_registry_len;
+
+int sensor_registry_add(const struct app_sensor *sensor)
+{
+        if (sensor->init == NULL || sensor->read == NULL)
+        {
+                return -EINVAL;
+        }
+        if (sensor_registry_len >= SENSOR_REGISTRY_MAX)
+        {
+                return -ENOMEM;
+        }
+        sensor_registry[sensor_registry_len++] = sensor;
+        return 0;
+}
+
+uint8_t sensor_registry_count(void)
+{
+        return sensor_registry_len;
+}
+
+const struct app_sensor *sensor_registry_get(uint8_t idx)
+{
+        return idx < sensor_registry_len ? sensor_registry[idx] : NULL;
+}
+
+uint32_t sensor_registry_channels(void)
+{
+        uint32_t channels = 0;
+
+        for (uint8_t i = 0; i < sensor_registry_len; i++)
+        {
+                channels |= sensor_registry[i]->channels;
+        }
+        return channels;
+}
+
+uint32_t sensor_registry_read_cost_us(void)
+{
+        uint32_t cost_us = 0;
+
+        for (uint8_t i = 0; i < sensor_registry_len; i++)
+        {
+                cost_us += sensor_registry[i]->read_cost_us;
+        }
+        return cost_us;
+}
+
+int16_t sensor_registry_access(const struct app_sensor *sensor, app_sensor_op_t op)
+{
+        int16_t error = 0;
+
+        /* The recovery layer logs when the sensor starts to back off */
+        if (!i2c_recovery_ready(sensor->bus, sensor->addr))
+        {
+                return -EBUSY;
+        }
+        if (i2c_bus_select(sensor->bus) != 0)
+        {
+                return -ENODEV;
+        }
+        if (i2c_recovery_needs_init(sensor->bus, sensor->addr))
+        {
+                error = sensor->init(sensor);
+                if (error == 0)
+                {
+                        i2c_recovery_initialized(sensor->bus, sensor->addr);
+                }
+        }
+        if (error == 0 && op != NULL)
+        {
+                error = op(sensor);
+        }
+        i2c_recovery_report(sensor->bus, sensor->addr, error == -EAGAIN ? 0 : error);
+        return error;
+}
@@ -0,0 +1,93 @@
+#ifndef SENSOR_REGISTRY_H
+#define SENSOR_REGISTRY_H
+
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+/* Number of sensors that can be registered */
+#define SENSOR_REGISTRY_MAX 8
+
+/* Quantities a sensor writes into the sample */
+#define SENSOR_REGISTRY_CH_CO2 BIT(0)
+#define SENSOR_REGISTRY_CH_TEMPERATURE BIT(1)
+#define SENSOR_REGISTRY_CH_HUMIDITY BIT(2)
+#define SENSOR_REGISTRY_CH_ECO2 BIT(3)
+#define SENSOR_REGISTRY_CH_TVOC BIT(4)
+#define SENSOR_REGISTRY_CH_PM BIT(5)
+
+struct app_sensor;
+
+/**
+ * An operation on one sensor.
+ *
+ * @returns 0 on success, -EAGAIN if a read found no fresh sample, an error
+ *          code otherwise
+ */
+typedef int16_t (*app_sensor_op_t)(const struct app_sensor *sensor);
+
+/**
+ * What the acquisition needs to know about a sensor. Drivers with several
+ * instances register one descriptor per instance and find it in ctx.
+ */
+struct app_sensor
+{
+        const char *name;
+        uint8_t bus;            /* bus index; with addr the recovery layer key */
+        uint16_t addr;          /* 7-bit address */
+        uint32_t channels;      /* SENSOR_REGISTRY_CH_* */
+        uint32_t min_period_ms; /* shortest time between two fresh samples */
+        uint32_t read_cost_us;  /* bus time of one read */
+        void *ctx;
+        app_sensor_op_t init;
+        app_sensor_op_t read;
+        /* time until the next sample is due if the driver knows it, or NULL */
+        int32_t (*ms_until_ready)(const struct app_sensor *sensor);
+        /* power state hooks, NULL if the sensor has none */
+        app_sensor_op_t suspend;
+        app_sensor_op_t resume;
+};
+
+/**
+ * Register a sensor. Sensors are read in the order they were registered.
+ *
+ * @returns 0 on success, -EINVAL if init or read is missing, -ENOMEM if the
+ *          registry is full
+ */
+int sensor_registry_add(const struct app_sensor *sensor);
+
+/**
+ * @returns the number of registered sensors
+ */
+uint8_t sensor_registry_count(void);
+
+/**
+ * @returns the idx-th registered sensor, NULL if there is none
+ */
+const struct app_sensor *sensor_registry_get(uint8_t idx);
+
+/**
+ * @returns the channels of all registered sensors
+ */
+uint32_t sensor_registry_channels(void);
+
+/**
+ * @returns the bus time of one read of every registered sensor
+ */
+uint32_t sensor_registry_read_cost_us(void);
+
+/**
+ * One access to a sensor under the recovery policy: skipped while the
+ * sensor backs off or is quarantined, preceded by its initialization when
+ * needed. A failing sensor never delays the others. An operation returning
+ * -EAGAIN found no fresh sample; the sensor answered, so that counts as a
+ * success. The sensor's bus is selected first, so drivers addressing by
+ * address only reach this sensor; it stays selected after the access. The
+ * sensor need not be registered.
+ *
+ * @param op Operation to run, NULL to only initialize the sensor if needed
+ * @returns -EBUSY if the sensor was skipped, -ENODEV if its bus is missing,
+ *          otherwise the result of the initialization or of op
+ */
+int16_t sensor_registry_access(const struct app_sensor *sensor, app_sensor_op_t op);
+
+#endif
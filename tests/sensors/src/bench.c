@@ -0,0 +1,31 @@
+#include <zephyr/toolchain.h>
+#include "bench.h"
+
+#define STACK_PATTERN 0x5A
+
+/* Both helpers have the same frame, so their areas cover the same stack
+ * below the caller; area[0] is the deepest byte. */
+__noinline void bench_stack_paint(void)
+{
+        volatile uint8_t area[BENCH_STACK_BYTES];
+
+        for (size_t i = 0; i < sizeof(area); i++)
+        {
+                area[i] = STACK_PATTERN;
+        }
+}
+
+__noinline size_t bench_stack_used(void)
+{
+        volatile uint8_t area[BENCH_STACK_BYTES];
+        size_t untouched = 0;
+
+        /* tells the compiler the area holds data, what the call left there */
+        __asm__ volatile("" : : "r"(area) : "memory");
+
+        while (untouched < sizeof(area) && area[untouched] == STACK_PATTERN)
+        {
+                untouched++;
+        }
+        return sizeof(area) - untouched;
+}
@@ -0,0 +1,36 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Repetitions per measurement; enough to drown the clock's resolution */
+#define BENCH_RUNS 20000
+
+/* Deepest call bench_stack_used() can measure */
+#define BENCH_STACK_BYTES 1024
+
+/**
+ * Host monotonic time. native_sim's uptime stands still while code runs,
+ * so CPU time is taken from the host, see bench_clock_bottom.c.
+ *
+ * @returns nanoseconds since an arbitrary start
+ */
+uint64_t bench_host_ns(void);
+
+/**
+ * Stack depth of a call, for native_sim where Zephyr's thread stacks are
+ * not the ones the code runs on. Call bench_stack_paint(), the function to
+ * measure and bench_stack_used() in a row from the same function: the first
+ * fills the stack below the caller with a pattern, the last finds how far
+ * down the call in between overwrote it.
+ */
+void bench_stack_paint(void);
+
+/**
+ * @returns bytes of stack the call since bench_stack_paint() used, an
+ *          approximation to within the helpers' own frame
+ */
+size_t bench_stack_used(void);
+
+#endif
@@ -0,0 +1,14 @@
+/*
+ * Built into the native_sim runner, so it uses the host's C library.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+uint64_t bench_host_ns(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000U + ts.tv_nsec;
+}
@@ -0,0 +1,96 @@
+/*
+ * CRC-8 of the Sensirion word streams: the lookup table against the bitwise
+ * loop it replaced, on the 20 words of an SPS30 measurement.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "../../../sensors/scd41/sensirion_common.h"
+#include "../../../sensors/scd41/sensirion_i2c.h"
+#include "bench.h"
+
+#define FRAME_WORDS 20
+
+static uint8_t frame[FRAME_WORDS * (SENSIRION_WORD_SIZE + CRC8_LEN)];
+/* read back on every run and kept, so no run is optimized away */
+static const uint8_t *volatile input = frame;
+static volatile uint32_t sink;
+
+/* sensirion_i2c_generate_crc() before the lookup table */
+static uint8_t crc_bitwise(const uint8_t *data, uint16_t count)
+{
+        uint8_t crc = CRC8_INIT;
+
+        for (uint16_t i = 0; i < count; i++)
+        {
+                crc ^= data[i];
+                for (uint8_t bit = 8; bit > 0; bit--)
+                {
+                        crc = crc & 0x80 ? (crc << 1) ^ CRC8_POLYNOMIAL : crc << 1;
+                }
+        }
+        return crc;
+}
+
+/* The per-word check the read helpers ran before sensirion_i2c_check_crc_words() */
+static int16_t check_bitwise(const uint8_t *buf, uint16_t num_words)
+{
+        for (uint16_t i = 0; i < num_words; i++, buf += SENSIRION_WORD_SIZE + CRC8_LEN)
+        {
+                if (crc_bitwise(buf, SENSIRION_WORD_SIZE) != buf[SENSIRION_WORD_SIZE])
+                {
+                        return CRC_ERROR;
+                }
+        }
+        return NO_ERROR;
+}
+
+static void *bench_setup(void)
+{
+        for (uint16_t i = 0; i < FRAME_WORDS; i++)
+        {
+                uint8_t *word = &frame[i * (SENSIRION_WORD_SIZE + CRC8_LEN)];
+
+                word[0] = 0x42 + i;
+                word[1] = 0x17 * i;
+                word[SENSIRION_WORD_SIZE] = crc_bitwise(word, SENSIRION_WORD_SIZE);
+        }
+        return NULL;
+}
+
+ZTEST_SUITE(sensors_bench, NULL, bench_setup, NULL, NULL, NULL);
+
+ZTEST(sensors_bench, test_crc_table_matches_bitwise)
+{
+        for (uint32_t w = 0; w <= UINT16_MAX; w++)
+        {
+                const uint8_t word[] = {w >> 8, w & 0xFF};
+
+                zassert_equal(sensirion_i2c_generate_crc(word, 2), crc_bitwise(word, 2), "word 0x%04x", w);
+        }
+}
+
+ZTEST(sensors_bench, test_crc_speed)
+{
+        uint64_t bitwise_ns;
+        uint64_t table_ns;
+        uint64_t start;
+
+        start = bench_host_ns();
+        for (uint32_t run = 0; run < BENCH_RUNS; run++)
+        {
+                sink += check_bitwise(input, FRAME_WORDS);
+        }
+        bitwise_ns = bench_host_ns() - start;
+
+        start = bench_host_ns();
+        for (uint32_t run = 0; run < BENCH_RUNS; run++)
+        {
+                sink += sensirion_i2c_check_crc_words(input, FRAME_WORDS, NULL);
+        }
+        table_ns = bench_host_ns() - start;
+
+        zassert_equal(sink, 0, "test frame failed its CRC check");
+        printk("CRC-8, %u words: bitwise %u ns, table %u ns\n", FRAME_WORDS,
+               (uint32_t)(bitwise_ns / BENCH_RUNS), (uint32_t)(table_ns / BENCH_RUNS));
+}
@@ -0,0 +1,128 @@
+/*
+ * Decoding an SPS30 measurement frame: straight from the receive buffer
+ * against the copies sps30_read_measurement() made before.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/toolchain.h>
+#include <zephyr/ztest.h>
+#include "../../../sensors/scd41/sensirion_common.h"
+#include "../../../sensors/scd41/sensirion_i2c.h"
+#include "../../../sensors/sps30/sps30.h"
+#include "bench.h"
+
+#define NUM_VALUES 10
+#define FRAME_BYTES (NUM_VALUES * 2 * (SENSIRION_WORD_SIZE + CRC8_LEN))
+
+/* as received from the sensor */
+static uint8_t rx[FRAME_BYTES];
+static const uint8_t *volatile input = rx;
+static struct sps30_measurement expected;
+
+/* sensirion_i2c_read_words_as_bytes() into a word buffer, copied out to
+ * uint8_t data[10][4] and converted value by value, as before */
+static __noinline int16_t decode_copying(const uint8_t *received, struct sps30_measurement *measurement)
+{
+        uint16_t word_buf[SENSIRION_MAX_BUFFER_WORDS];
+        uint8_t *buf8 = (uint8_t *)word_buf;
+        uint8_t data[NUM_VALUES][4];
+        uint8_t *out = &data[0][0];
+        float *values = &measurement->mc_1p0;
+
+        memcpy(buf8, received, FRAME_BYTES);
+        for (uint16_t i = 0; i < FRAME_BYTES; i += SENSIRION_WORD_SIZE + CRC8_LEN)
+        {
+                if (sensirion_i2c_check_crc(&buf8[i], SENSIRION_WORD_SIZE, buf8[i + SENSIRION_WORD_SIZE]) !=
+                    NO_ERROR)
+                {
+                        return CRC_ERROR;
+                }
+                *out++ = buf8[i];
+                *out++ = buf8[i + 1];
+        }
+        for (uint8_t i = 0; i < NUM_VALUES; i++)
+        {
+                values[i] = sensirion_bytes_to_float(data[i]);
+        }
+        return NO_ERROR;
+}
+
+/* sps30_read_measurement() now */
+static __noinline int16_t decode_direct(const uint8_t *received, struct sps30_measurement *measurement)
+{
+        uint8_t frame[FRAME_BYTES];
+
+        memcpy(frame, received, FRAME_BYTES);
+        return sensirion_i2c_decode_float(frame, NUM_VALUES, &measurement->mc_1p0);
+}
+
+static uint64_t time_decode(int16_t (*decode)(const uint8_t *, struct sps30_measurement *))
+{
+        struct sps30_measurement measurement;
+        uint64_t start = bench_host_ns();
+
+        for (uint32_t run = 0; run < BENCH_RUNS; run++)
+        {
+                decode(input, &measurement);
+        }
+        return bench_host_ns() - start;
+}
+
+static void *bench_setup(void)
+{
+        float *values = &expected.mc_1p0;
+
+        for (uint8_t i = 0; i < NUM_VALUES; i++)
+        {
+                uint8_t *pair = &rx[i * 2 * (SENSIRION_WORD_SIZE + CRC8_LEN)];
+                uint32_t raw;
+
+                values[i] = 1.5f * i + 0.25f;
+                memcpy(&raw, &values[i], sizeof(raw));
+                pair[0] = raw >> 24;
+                pair[1] = raw >> 16;
+                pair[2] = sensirion_i2c_generate_crc(&pair[0], SENSIRION_WORD_SIZE);
+                pair[3] = raw >> 8;
+                pair[4] = raw;
+                pair[5] = sensirion_i2c_generate_crc(&pair[3], SENSIRION_WORD_SIZE);
+        }
+        return NULL;
+}
+
+ZTEST_SUITE(sensors_bench_decode, NULL, bench_setup, NULL, NULL, NULL);
+
+ZTEST(sensors_bench_decode, test_decode_same_result)
+{
+        struct sps30_measurement copying;
+        struct sps30_measurement direct;
+
+        zassert_equal(decode_copying(rx, &copying), NO_ERROR);
+        zassert_equal(decode_direct(rx, &direct), NO_ERROR);
+        zassert_mem_equal(&copying, &expected, sizeof(expected));
+        zassert_mem_equal(&direct, &expected, sizeof(expected));
+}
+
+ZTEST(sensors_bench_decode, test_decode_cost)
+{
+        struct sps30_measurement measurement;
+        size_t copying_stack;
+        size_t direct_stack;
+        uint64_t copying_ns;
+        uint64_t direct_ns;
+
+        bench_stack_paint();
+        decode_copying(rx, &measurement);
+        copying_stack = bench_stack_used();
+
+        bench_stack_paint();
+        decode_direct(rx, &measurement);
+        direct_stack = bench_stack_used();
+
+        copying_ns = time_decode(decode_copying);
+        direct_ns = time_decode(decode_direct);
+
+        printk("SPS30 decode: copying %u ns, %u B stack; direct %u ns, %u B stack\n",
+               (uint32_t)(copying_ns / BENCH_RUNS), (uint32_t)copying_stack,
+               (uint32_t)(direct_ns / BENCH_RUNS), (uint32_t)direct_stack);
+}
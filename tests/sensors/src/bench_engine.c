@@ -0,0 +1,101 @@
+/*
+ * Latency of a transfer through the I2C engine on the emulated bus: queued
+ * and waited for, queued with a completion callback, and i2c_transfer()
+ * called in place as the drivers did before the engine.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/i2c.h>
+#include "../../../sensors/scd41/scd4x_i2c.h"
+#include "../../../sensors/i2c/i2c_bus.h"
+#include "../../../sensors/i2c/i2c_engine.h"
+#include "bench.h"
+#include "sensors_test.h"
+
+/* Transfers per measurement; each one runs the emulator */
+#define ENGINE_RUNS 2000
+
+/* get_data_ready_flag, answered by the SCD41 whenever it is awake */
+static const uint8_t command[] = {0xE4, 0xB8};
+
+static K_SEM_DEFINE(txn_done, 0, 1);
+static uint64_t done_ns;
+
+static void command_msg(struct i2c_msg *msg)
+{
+        msg->buf = (uint8_t *)command;
+        msg->len = sizeof(command);
+        msg->flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+}
+
+static void txn_cb(struct i2c_txn *txn, int result)
+{
+        done_ns = bench_host_ns();
+        k_sem_give(&txn_done);
+}
+
+static void *bench_setup(void)
+{
+        sensors_test_setup();
+        return NULL;
+}
+
+static void bench_before(void *fixture)
+{
+        scd4x_wake_up();
+        scd4x_stop_periodic_measurement();
+}
+
+ZTEST_SUITE(sensors_bench_engine, NULL, bench_setup, bench_before, NULL, NULL);
+
+ZTEST(sensors_bench_engine, test_engine_latency)
+{
+        struct i2c_bus *bus = i2c_bus_get(SENSORS_TEST_BUS);
+        struct i2c_msg msg;
+        struct i2c_txn txn = {
+                .bus = bus,
+                .addr = SCD4X_I2C_ADDRESS,
+                .msgs = &msg,
+                .num_msgs = 1,
+                .cb = txn_cb,
+        };
+        uint64_t callback_ns = 0;
+        uint64_t blocking_ns;
+        uint64_t direct_ns;
+        uint64_t start;
+
+        zassert_not_null(bus);
+
+        /* under the bus lock, as the engine thread runs it */
+        i2c_bus_lock(bus, K_FOREVER);
+        start = bench_host_ns();
+        for (uint32_t run = 0; run < ENGINE_RUNS; run++)
+        {
+                command_msg(&msg);
+                zassert_ok(i2c_transfer(bus->dev, &msg, 1, SCD4X_I2C_ADDRESS));
+        }
+        direct_ns = bench_host_ns() - start;
+        i2c_bus_unlock(bus);
+
+        start = bench_host_ns();
+        for (uint32_t run = 0; run < ENGINE_RUNS; run++)
+        {
+                zassert_ok(i2c_engine_write(bus, SCD4X_I2C_ADDRESS, command, sizeof(command)));
+        }
+        blocking_ns = bench_host_ns() - start;
+
+        for (uint32_t run = 0; run < ENGINE_RUNS; run++)
+        {
+                command_msg(&msg);
+                start = bench_host_ns();
+                zassert_ok(i2c_engine_submit(&txn));
+                k_sem_take(&txn_done, K_FOREVER);
+                callback_ns += done_ns - start;
+                zassert_ok(txn.result);
+        }
+
+        printk("I2C write, %u B: in place %u ns, engine blocking %u ns, submit to callback %u ns\n",
+               (uint32_t)sizeof(command), (uint32_t)(direct_ns / ENGINE_RUNS),
+               (uint32_t)(blocking_ns / ENGINE_RUNS), (uint32_t)(callback_ns / ENGINE_RUNS));
+}
@@ -0,0 +1,99 @@
+/*
+ * Bus time of an SPS30 measurement read, all ten values against the mass
+ * concentrations only, on the emulated sensor.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "../../../sensors/scd41/sensirion_common.h"
+#include "../../../sensors/scd41/sensirion_i2c.h"
+#include "../../../sensors/sps30/sps30.h"
+#include "bench.h"
+#include "sensors_test.h"
+
+/* Reads per measurement; each one is a bus transfer on the emulator */
+#define READ_RUNS 200
+
+/* Bit times of a transfer besides its data: start, address with its ACK,
+ * stop */
+#define TRANSFER_OVERHEAD_BITS 11
+#define STANDARD_MODE_BIT_NS 10000
+
+struct read_cost
+{
+        uint32_t bytes;
+        uint32_t transfers;
+        uint32_t bus_us;  /* at 100 kHz */
+        uint32_t host_ns; /* driver, I2C layer and emulator */
+};
+
+static struct read_cost measure_read(uint16_t fields)
+{
+        struct sps30_measurement_milli measurement;
+        struct i2c_stats_snapshot before = sensors_test_stats(SPS30_I2C_ADDRESS);
+        struct i2c_stats_snapshot after;
+        struct read_cost cost;
+        uint64_t start = bench_host_ns();
+
+        for (uint32_t run = 0; run < READ_RUNS; run++)
+        {
+                zassert_equal(sps30_read_measurement_fields(&measurement, fields), NO_ERROR);
+        }
+        cost.host_ns = (bench_host_ns() - start) / READ_RUNS;
+
+        after = sensors_test_stats(SPS30_I2C_ADDRESS);
+        cost.bytes = (after.bytes - before.bytes) / READ_RUNS;
+        cost.transfers = (after.transactions - before.transactions) / READ_RUNS;
+        /* 8 data bits and an ACK per byte */
+        cost.bus_us = (cost.bytes * 9 + cost.transfers * TRANSFER_OVERHEAD_BITS) * STANDARD_MODE_BIT_NS / 1000;
+        return cost;
+}
+
+static void compare_fields(const char *format, uint32_t value_bytes)
+{
+        struct read_cost all;
+        struct read_cost mass;
+
+        k_msleep(SPS30_MEASUREMENT_INTERVAL_MS);
+        all = measure_read(SPS30_FIELDS_ALL);
+        mass = measure_read(SPS30_FIELDS_MASS);
+
+        printk("SPS30 %s read: all %u B, %u us bus, %u ns host; mass %u B, %u us bus, %u ns host\n",
+               format, all.bytes, all.bus_us, all.host_ns, mass.bytes, mass.bus_us, mass.host_ns);
+
+        /* command word, then per value its words with their CRCs */
+        zassert_equal(all.bytes, SENSIRION_COMMAND_SIZE + 10 * value_bytes);
+        zassert_equal(mass.bytes, SENSIRION_COMMAND_SIZE + 4 * value_bytes);
+        zassert_equal(all.transfers, mass.transfers);
+}
+
+static void *bench_setup(void)
+{
+        sensors_test_setup();
+        return NULL;
+}
+
+static void bench_before(void *fixture)
+{
+        sps30_wake_up();
+        sps30_stop_measurement();
+}
+
+static void bench_after(void *fixture)
+{
+        sps30_stop_measurement();
+}
+
+ZTEST_SUITE(sensors_bench_sps30, NULL, bench_setup, bench_before, bench_after, NULL);
+
+ZTEST(sensors_bench_sps30, test_fields_float)
+{
+        zassert_equal(sps30_start_measurement(), NO_ERROR);
+        compare_fields("float", 2 * (SENSIRION_WORD_SIZE + CRC8_LEN));
+}
+
+ZTEST(sensors_bench_sps30, test_fields_u16)
+{
+        zassert_equal(sps30_start_measurement_u16(), NO_ERROR);
+        compare_fields("u16", SENSIRION_WORD_SIZE + CRC8_LEN);
+}
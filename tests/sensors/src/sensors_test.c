@@ -0,0 +1,36 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include "../../../sensors/scd41/scd4x_i2c.h"
+#include "../../../sensors/scd41/sensirion_i2c_hal.h"
+#include "../../../sensors/sps30/sps30.h"
+#include "../../../sensors/i2c/i2c_bus.h"
+#include "sensors_test.h"
+
+void sensors_test_setup(void)
+{
+        static bool done;
+
+        if (done)
+        {
+                return;
+        }
+        sensirion_i2c_hal_select_bus(SENSORS_TEST_BUS);
+        sensirion_i2c_hal_init();
+        sensirion_i2c_init();
+        done = true;
+}
+
+struct i2c_stats_snapshot sensors_test_stats(uint16_t addr)
+{
+        struct i2c_stats_snapshot snap;
+
+        for (uint8_t n = 0; i2c_stats_get(n, &snap) == 0; n++)
+        {
+                if (snap.bus == SENSORS_TEST_BUS && snap.addr == addr)
+                {
+                        return snap;
+                }
+        }
+        memset(&snap, 0, sizeof(snap));
+        return snap;
+}
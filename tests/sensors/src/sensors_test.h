@@ -0,0 +1,22 @@
+#ifndef SENSORS_TEST_H
+#define SENSORS_TEST_H
+
+#include <stdint.h>
+#include "../../../sensors/i2c/i2c_stats.h"
+
+/* Bus the emulated sensors are on, see boards/native_sim.overlay */
+#define SENSORS_TEST_BUS 0
+
+/**
+ * Select the bus of the sensors and set up the HALs, as the application
+ * does at boot. Safe to call from every suite.
+ */
+void sensors_test_setup(void);
+
+/**
+ * @returns the bus counters of the device at addr on SENSORS_TEST_BUS, all
+ *          zero if it has not been accessed yet
+ */
+struct i2c_stats_snapshot sensors_test_stats(uint16_t addr);
+
+#endif
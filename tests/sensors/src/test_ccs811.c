@@ -0,0 +1,88 @@
+/*
+ * The CCS811 baseline on the polled emulated sensor: stored once the sensor
+ * ran a save interval, and written back after the run-in of a restart.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/pm/device_runtime.h>
+#include "../../../sensors/ccs811/ccs811_sensor.h"
+#include "../../../sensors/ccs811/ccs811_baseline.h"
+#include "sensors_test.h"
+
+/* Tries of ccs811_sensor_start() while the sensor boots */
+#define START_TRIES 100
+#define START_RETRY_MS 10
+/* Slack for the uptime passing between two calls */
+#define DUE_MARGIN_MS 10
+
+#define BASELINE_CONDITIONED 0x1234
+#define BASELINE_FRESH 0x4321
+
+static const struct device *const ccs811 = DEVICE_DT_GET(DT_NODELABEL(ccs811_b));
+
+static void *ccs811_setup(void)
+{
+        int ret = -EAGAIN;
+
+        sensors_test_setup();
+        zassert_ok(pm_device_runtime_get(ccs811));
+        for (uint8_t try = 0; ret == -EAGAIN && try < START_TRIES; try++)
+        {
+                k_msleep(START_RETRY_MS);
+                ret = ccs811_sensor_start(ccs811);
+        }
+        zassert_ok(ret);
+        zassert_ok(ccs811_baseline_init(CCS811_BASELINE_CHECK_MS));
+        return NULL;
+}
+
+static void ccs811_teardown(void *fixture)
+{
+        pm_device_runtime_put(ccs811);
+}
+
+ZTEST_SUITE(sensors_ccs811, NULL, ccs811_setup, NULL, NULL, ccs811_teardown);
+
+static void wait_until_due(void)
+{
+        k_msleep(ccs811_baseline_ms_until_due(ccs811));
+        zassert_equal(ccs811_baseline_ms_until_due(ccs811), 0);
+}
+
+ZTEST(sensors_ccs811, test_baseline)
+{
+        uint16_t baseline;
+
+        zassert_ok(ccs811_sensor_baseline_update(ccs811, BASELINE_CONDITIONED));
+        ccs811_baseline_start(ccs811);
+        zassert_true(ccs811_baseline_ms_until_due(ccs811) + DUE_MARGIN_MS >= CCS811_BASELINE_RUN_IN_MS);
+
+        /* nothing is read or written during the run-in */
+        zassert_ok(ccs811_baseline_update(ccs811));
+        zassert_ok(ccs811_sensor_baseline_fetch(ccs811, &baseline));
+        zassert_equal(baseline, BASELINE_CONDITIONED);
+
+        /* nothing stored yet to restore, and the sensor has not run a save
+         * interval */
+        wait_until_due();
+        zassert_ok(ccs811_baseline_update(ccs811));
+        zassert_true(ccs811_baseline_ms_until_due(ccs811) + DUE_MARGIN_MS >= CCS811_BASELINE_CHECK_MS);
+
+        /* stored by the next check */
+        wait_until_due();
+        zassert_ok(ccs811_baseline_update(ccs811));
+
+        /* a restart begins from a fresh baseline and gets the stored one back
+         * once the run-in is over */
+        zassert_ok(ccs811_sensor_baseline_update(ccs811, BASELINE_FRESH));
+        ccs811_baseline_start(ccs811);
+        zassert_ok(ccs811_baseline_update(ccs811));
+        zassert_ok(ccs811_sensor_baseline_fetch(ccs811, &baseline));
+        zassert_equal(baseline, BASELINE_FRESH);
+
+        wait_until_due();
+        zassert_ok(ccs811_baseline_update(ccs811));
+        zassert_ok(ccs811_sensor_baseline_fetch(ccs811, &baseline));
+        zassert_equal(baseline, BASELINE_CONDITIONED, "baseline 0x%04x", baseline);
+}
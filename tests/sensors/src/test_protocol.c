@@ -0,0 +1,231 @@
+/*
+ * The sensor drivers against the emulated sensors: CRC errors injected into
+ * the responses, the data-ready timing of each sensor and the NACKs of a
+ * sleeping sensor.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/pm/device_runtime.h>
+#include "../../../sensors/scd41/scd4x_i2c.h"
+#include "../../../sensors/scd41/sensirion_common.h"
+#include "../../../sensors/scd41/sensirion_i2c.h"
+#include "../../../sensors/sps30/sps30.h"
+#include "../../../sensors/ccs811/ccs811_sensor.h"
+#include "../../../sensors/emul/sensirion_emul.h"
+#include "sensors_test.h"
+
+/* Slack on the emulators' sample times */
+#define TIMING_MARGIN_MS 200
+
+static const struct emul *const scd41_emul = EMUL_DT_GET(DT_NODELABEL(scd41));
+static const struct emul *const sps30_emul = EMUL_DT_GET(DT_NODELABEL(sps30));
+static const struct device *const ccs811 = DEVICE_DT_GET(DT_NODELABEL(ccs811));
+
+static K_SEM_DEFINE(ccs811_ready, 0, 1);
+
+static void ccs811_handler(const struct device *dev, const struct sensor_trigger *trig)
+{
+        k_sem_give(&ccs811_ready);
+}
+
+static void *protocol_setup(void)
+{
+        sensors_test_setup();
+        return NULL;
+}
+
+/* Every test starts from idle, awake sensors */
+static void protocol_before(void *fixture)
+{
+        scd4x_wake_up();
+        scd4x_stop_periodic_measurement();
+        sps30_wake_up();
+        sps30_stop_measurement();
+}
+
+ZTEST_SUITE(sensors_protocol, NULL, protocol_setup, protocol_before, NULL, NULL);
+
+/* Example from the SCD4x and SPS30 datasheets */
+ZTEST(sensors_protocol, test_crc_reference)
+{
+        const uint8_t word[] = {0xBE, 0xEF};
+
+        zassert_equal(sensirion_i2c_generate_crc(word, sizeof(word)), 0x92);
+}
+
+ZTEST(sensors_protocol, test_crc_failing_word)
+{
+        uint8_t frame[4 * 3];
+        uint16_t failed_word = 0xFFFF;
+
+        for (uint8_t i = 0; i < 4; i++)
+        {
+                frame[i * 3] = i;
+                frame[i * 3 + 1] = 0x40 + i;
+                frame[i * 3 + 2] = sensirion_i2c_generate_crc(&frame[i * 3], 2);
+        }
+        zassert_equal(sensirion_i2c_check_crc_words(frame, 4, &failed_word), NO_ERROR);
+
+        frame[2 * 3 + 1] ^= 0x01;
+        zassert_equal(sensirion_i2c_check_crc_words(frame, 4, &failed_word), CRC_ERROR);
+        zassert_equal(failed_word, 2);
+}
+
+ZTEST(sensors_protocol, test_scd41_data_ready_timing)
+{
+        uint16_t co2;
+        uint16_t temperature;
+        uint16_t humidity;
+        bool ready;
+
+        zassert_equal(scd4x_start_periodic_measurement(), NO_ERROR);
+
+        k_msleep(SCD4X_PERIODIC_INTERVAL_MS - TIMING_MARGIN_MS);
+        zassert_equal(scd4x_get_data_ready_flag(&ready), NO_ERROR);
+        zassert_false(ready, "sample ahead of the measurement interval");
+        /* the sensor NACKs a read without a sample */
+        zassert_not_equal(scd4x_read_measurement_ticks(&co2, &temperature, &humidity), NO_ERROR);
+
+        k_msleep(2 * TIMING_MARGIN_MS);
+        zassert_equal(scd4x_get_data_ready_flag(&ready), NO_ERROR);
+        zassert_true(ready, "no sample after the measurement interval");
+        zassert_equal(scd4x_read_measurement_ticks(&co2, &temperature, &humidity), NO_ERROR);
+        zassert_not_equal(co2, 0);
+
+        /* reading the sample clears the flag */
+        zassert_equal(scd4x_get_data_ready_flag(&ready), NO_ERROR);
+        zassert_false(ready);
+}
+
+ZTEST(sensors_protocol, test_scd41_crc_injection)
+{
+        struct i2c_stats_snapshot before;
+        uint16_t co2;
+        uint16_t temperature;
+        uint16_t humidity;
+        bool ready;
+
+        zassert_equal(scd4x_start_periodic_measurement(), NO_ERROR);
+        k_msleep(SCD4X_PERIODIC_INTERVAL_MS + TIMING_MARGIN_MS);
+
+        before = sensors_test_stats(SCD4X_I2C_ADDRESS);
+        sensirion_emul_inject_crc_errors(scd41_emul, 1);
+        zassert_equal(scd4x_read_measurement_ticks(&co2, &temperature, &humidity), CRC_ERROR);
+        zassert_equal(sensors_test_stats(SCD4X_I2C_ADDRESS).crc_errors, before.crc_errors + 1);
+
+        /* single word responses take the same path */
+        sensirion_emul_inject_crc_errors(scd41_emul, 1);
+        zassert_equal(scd4x_get_data_ready_flag(&ready), CRC_ERROR);
+        zassert_equal(sensors_test_stats(SCD4X_I2C_ADDRESS).crc_errors, before.crc_errors + 2);
+
+        /* the corrupted sample is gone, the next one is fine */
+        k_msleep(SCD4X_PERIODIC_INTERVAL_MS);
+        zassert_equal(scd4x_read_measurement_ticks(&co2, &temperature, &humidity), NO_ERROR);
+        zassert_not_equal(co2, 0);
+}
+
+ZTEST(sensors_protocol, test_scd41_nack_after_sleep)
+{
+        struct i2c_stats_snapshot before;
+        uint16_t serial[3];
+
+        zassert_equal(scd4x_power_down(), NO_ERROR);
+
+        before = sensors_test_stats(SCD4X_I2C_ADDRESS);
+        zassert_not_equal(scd4x_get_serial_number(&serial[0], &serial[1], &serial[2]), NO_ERROR);
+        zassert_true(sensors_test_stats(SCD4X_I2C_ADDRESS).nacks > before.nacks);
+
+        zassert_equal(scd4x_wake_up(), NO_ERROR);
+        zassert_equal(scd4x_get_serial_number(&serial[0], &serial[1], &serial[2]), NO_ERROR);
+}
+
+ZTEST(sensors_protocol, test_sps30_data_ready_timing)
+{
+        uint16_t ready;
+
+        zassert_equal(sps30_start_measurement(), NO_ERROR);
+
+        k_msleep(SPS30_MEASUREMENT_INTERVAL_MS - TIMING_MARGIN_MS);
+        zassert_equal(sps30_read_data_ready(&ready), NO_ERROR);
+        zassert_equal(ready, 0, "sample ahead of the measurement interval");
+
+        k_msleep(2 * TIMING_MARGIN_MS);
+        zassert_equal(sps30_read_data_ready(&ready), NO_ERROR);
+        zassert_equal(ready, 1, "no sample after the measurement interval");
+}
+
+ZTEST(sensors_protocol, test_sps30_crc_injection)
+{
+        struct sps30_measurement_milli measurement;
+        struct i2c_stats_snapshot before;
+
+        zassert_equal(sps30_start_measurement(), NO_ERROR);
+        k_msleep(SPS30_MEASUREMENT_INTERVAL_MS + TIMING_MARGIN_MS);
+
+        before = sensors_test_stats(SPS30_I2C_ADDRESS);
+        sensirion_emul_inject_crc_errors(sps30_emul, 1);
+        zassert_equal(sps30_read_measurement_fields(&measurement, SPS30_FIELDS_MASS), CRC_ERROR);
+        zassert_equal(sensors_test_stats(SPS30_I2C_ADDRESS).crc_errors, before.crc_errors + 1);
+
+        zassert_equal(sps30_read_measurement_fields(&measurement, SPS30_FIELDS_MASS), NO_ERROR);
+}
+
+ZTEST(sensors_protocol, test_sps30_nack_after_sleep)
+{
+        struct i2c_stats_snapshot before;
+        uint8_t major;
+        uint8_t minor;
+
+        zassert_equal(sps30_sleep(), NO_ERROR);
+
+        before = sensors_test_stats(SPS30_I2C_ADDRESS);
+        zassert_not_equal(sps30_read_firmware_version(&major, &minor), NO_ERROR);
+        zassert_true(sensors_test_stats(SPS30_I2C_ADDRESS).nacks > before.nacks);
+
+        zassert_equal(sps30_wake_up(), NO_ERROR);
+        zassert_equal(sps30_read_firmware_version(&major, &minor), NO_ERROR);
+}
+
+/* The firmware boots without a thread waiting for it, then nINT reports
+ * each result of drive mode 1. */
+ZTEST(sensors_protocol, test_ccs811_start_and_data_ready)
+{
+        static const struct sensor_trigger trig = {
+                .type = SENSOR_TRIG_DATA_READY,
+                .chan = SENSOR_CHAN_ALL,
+        };
+        struct ccs811_result result;
+        int64_t started;
+        int64_t elapsed;
+
+        zassert_true(device_is_ready(ccs811));
+        zassert_ok(pm_device_runtime_get(ccs811));
+        zassert_ok(sensor_trigger_set(ccs811, &trig, ccs811_handler));
+
+        zassert_equal(ccs811_sensor_start(ccs811), -EAGAIN);
+        zassert_equal(ccs811_sensor_start(ccs811), -EAGAIN, "started while booting");
+        k_msleep(TIMING_MARGIN_MS);
+        zassert_ok(ccs811_sensor_start(ccs811));
+        started = k_uptime_get();
+        k_sem_reset(&ccs811_ready);
+
+        zassert_equal(sensor_sample_fetch(ccs811), -ENODATA);
+        zassert_false(ccs811_sensor_irq_pending(ccs811));
+
+        zassert_ok(k_sem_take(&ccs811_ready, K_MSEC(ccs811_sensor_period_ms(ccs811) + TIMING_MARGIN_MS)));
+        elapsed = k_uptime_get() - started;
+        zassert_true(elapsed + TIMING_MARGIN_MS >= ccs811_sensor_period_ms(ccs811),
+                     "result after %lld ms", elapsed);
+        zassert_true(ccs811_sensor_irq_pending(ccs811));
+
+        zassert_ok(sensor_sample_fetch(ccs811));
+        ccs811_sensor_result(ccs811, &result);
+        zassert_true(result.status & CCS811_STATUS_DATA_READY);
+        zassert_false(ccs811_sensor_irq_pending(ccs811), "nINT held after the result was read");
+
+        zassert_ok(sensor_trigger_set(ccs811, &trig, NULL));
+        zassert_ok(pm_device_runtime_put(ccs811));
+}
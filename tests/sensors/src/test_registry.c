@@ -0,0 +1,153 @@
+/*
+ * sensor_registry_access() under the recovery policy of the I2C layer, with
+ * a sensor whose operations only return what the test asks for.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "../../../src/sensor_registry.h"
+#include "../../../sensors/scd41/sensirion_i2c.h"
+#include "../../../sensors/sps30/sps30.h"
+#include "../../../sensors/i2c/i2c_bus.h"
+#include "../../../sensors/i2c/i2c_recovery.h"
+#include "../../../sensors/i2c/i2c_stats.h"
+#include "sensors_test.h"
+
+/* No emulator answers here; the operations never reach the bus */
+#define STUB_ADDR 0x10
+
+static int16_t init_result;
+static int16_t read_result;
+static uint8_t inits;
+static uint8_t reads;
+
+static int16_t init_stub(const struct app_sensor *sensor)
+{
+        inits++;
+        return init_result;
+}
+
+static int16_t read_stub(const struct app_sensor *sensor)
+{
+        reads++;
+        return read_result;
+}
+
+static const struct app_sensor stub_sensor = {
+        .name = "stub",
+        .bus = SENSORS_TEST_BUS,
+        .addr = STUB_ADDR,
+        .init = init_stub,
+        .read = read_stub,
+};
+
+static void *registry_setup(void)
+{
+        sensors_test_setup();
+        return NULL;
+}
+
+/* Every test starts with a healthy sensor that needs its initialization */
+static void registry_before(void *fixture)
+{
+        zassert_ok(i2c_recovery_register(SENSORS_TEST_BUS, STUB_ADDR, NULL));
+        init_result = 0;
+        read_result = 0;
+        inits = 0;
+        reads = 0;
+}
+
+ZTEST_SUITE(sensors_registry, NULL, registry_setup, registry_before, NULL, NULL);
+
+ZTEST(sensors_registry, test_add)
+{
+        struct app_sensor incomplete = stub_sensor;
+        uint8_t count = sensor_registry_count();
+
+        incomplete.read = NULL;
+        zassert_equal(sensor_registry_add(&incomplete), -EINVAL);
+        zassert_equal(sensor_registry_count(), count);
+        zassert_is_null(sensor_registry_get(count));
+}
+
+/* The sensor is initialized on its first access only */
+ZTEST(sensors_registry, test_init_once)
+{
+        zassert_equal(sensor_registry_access(&stub_sensor, stub_sensor.read), 0);
+        zassert_equal(sensor_registry_access(&stub_sensor, stub_sensor.read), 0);
+        zassert_equal(sensor_registry_access(&stub_sensor, NULL), 0);
+        zassert_equal(inits, 1);
+        zassert_equal(reads, 2);
+        zassert_false(i2c_recovery_needs_init(SENSORS_TEST_BUS, STUB_ADDR));
+}
+
+/* A failed initialization is repeated on the next access, without the
+ * operation running in between */
+ZTEST(sensors_registry, test_init_retried)
+{
+        init_result = -EAGAIN;
+        zassert_equal(sensor_registry_access(&stub_sensor, stub_sensor.read), -EAGAIN);
+        zassert_equal(reads, 0);
+        zassert_true(i2c_recovery_needs_init(SENSORS_TEST_BUS, STUB_ADDR));
+
+        init_result = 0;
+        zassert_equal(sensor_registry_access(&stub_sensor, stub_sensor.read), 0);
+        zassert_equal(inits, 2);
+        zassert_equal(reads, 1);
+}
+
+/* A sensor without a fresh sample answered; it is not held back */
+ZTEST(sensors_registry, test_no_sample_is_no_failure)
+{
+        read_result = -EAGAIN;
+        zassert_equal(sensor_registry_access(&stub_sensor, stub_sensor.read), -EAGAIN);
+        zassert_equal(sensor_registry_access(&stub_sensor, stub_sensor.read), -EAGAIN);
+        zassert_true(i2c_recovery_ready(SENSORS_TEST_BUS, STUB_ADDR));
+        zassert_equal(reads, 2);
+}
+
+/* A failing sensor is skipped until its backoff ran out, then read again
+ * without a new initialization */
+ZTEST(sensors_registry, test_failure_backoff)
+{
+        zassert_equal(sensor_registry_access(&stub_sensor, stub_sensor.read), 0);
+
+        read_result = CRC_ERROR;
+        zassert_equal(sensor_registry_access(&stub_sensor, stub_sensor.read), CRC_ERROR);
+        zassert_equal(sensor_registry_access(&stub_sensor, stub_sensor.read), -EBUSY);
+        zassert_equal(reads, 2);
+
+        read_result = 0;
+        k_msleep(I2C_RECOVERY_BACKOFF_MIN_MS);
+        zassert_equal(sensor_registry_access(&stub_sensor, stub_sensor.read), 0);
+        zassert_equal(inits, 1);
+        zassert_equal(reads, 3);
+}
+
+/* A sensor on a bus that does not exist is not accessed at all */
+ZTEST(sensors_registry, test_missing_bus)
+{
+        struct app_sensor elsewhere = stub_sensor;
+
+        elsewhere.bus = I2C_BUS_MAX;
+        zassert_equal(sensor_registry_access(&elsewhere, elsewhere.read), -ENODEV);
+        zassert_equal(inits, 0);
+        zassert_equal(reads, 0);
+}
+
+/* A sensor at the same address on another bus is a device of its own: its
+ * failures neither hold back nor are counted for the one on the test bus. */
+ZTEST(sensors_registry, test_same_address_other_bus)
+{
+        const uint8_t other_bus = SENSORS_TEST_BUS + 1;
+        struct i2c_stats_snapshot before = sensors_test_stats(SPS30_I2C_ADDRESS);
+
+        zassert_ok(i2c_recovery_register(other_bus, SPS30_I2C_ADDRESS, NULL));
+        i2c_recovery_initialized(other_bus, SPS30_I2C_ADDRESS);
+        i2c_recovery_report(other_bus, SPS30_I2C_ADDRESS, -EIO);
+        i2c_stats_record_crc_error(other_bus, SPS30_I2C_ADDRESS);
+
+        zassert_false(i2c_recovery_ready(other_bus, SPS30_I2C_ADDRESS));
+        zassert_true(i2c_recovery_ready(SENSORS_TEST_BUS, SPS30_I2C_ADDRESS));
+        zassert_equal(sensors_test_stats(SPS30_I2C_ADDRESS).crc_errors, before.crc_errors);
+}
@@ -0,0 +1,74 @@
+/*
+ * The JSON payload of a sample: the rounding of the integer readings to two
+ * places and the members that depend on what the SPS30 reads.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "../../../src/sample.h"
+
+/* The members in front of and after the particle size */
+#define JSON_MASS "{\"CO\":612.00,\"Hm\":45.68,\"Tp\":-1.23,\"eCO\":400.00,\"1p0\":1.00," \
+                  "\"2p5\":3.00,\"4p0\":0.00,\"10p0\":0.01"
+#define JSON_SIZE ",\"ps\":0.55"
+#define JSON_TAIL ",\"tv\":7.00,\"pv\":1,\"ph\":\"degraded\",\"pst\":2097152}"
+
+static const struct sample sample = {
+        .pm = {
+                .mc_1p0 = 1004,
+                .mc_2p5 = 2995,
+                .mc_4p0 = 0,
+                .mc_10p0 = 10,
+                .typical_particle_size = 550,
+        },
+        .temperature = -1234,
+        .humidity = 45678,
+        .pm_status = SPS30_DEVICE_STATUS_FAN_SPEED_WARNING,
+        .co2 = 612,
+        .eco2 = 400,
+        .tvoc = 7,
+        .pm_health = SPS30_HEALTH_DEGRADED,
+        .pm_valid = true,
+};
+
+static char buf[256];
+
+ZTEST_SUITE(sensors_sample, NULL, NULL, NULL, NULL, NULL);
+
+/* "ps" is only sent if the SPS30 reads it, see
+ * CONFIG_APP_SPS30_READ_SIZE_DISTRIBUTION */
+ZTEST(sensors_sample, test_json)
+{
+        const char *expected = IS_ENABLED(CONFIG_APP_SPS30_READ_SIZE_DISTRIBUTION)
+                                       ? JSON_MASS JSON_SIZE JSON_TAIL
+                                       : JSON_MASS JSON_TAIL;
+
+        zassert_equal(sample_to_json(&sample, buf, sizeof(buf)), strlen(expected));
+        zassert_equal(strcmp(buf, expected), 0, "%s", buf);
+}
+
+/* A negative value that rounds to zero has no sign */
+ZTEST(sensors_sample, test_json_negative_zero)
+{
+        struct sample near_zero = sample;
+
+        near_zero.temperature = -4;
+        sample_to_json(&near_zero, buf, sizeof(buf));
+        zassert_not_null(strstr(buf, ",\"Tp\":0.00,"), "%s", buf);
+
+        near_zero.temperature = -5;
+        sample_to_json(&near_zero, buf, sizeof(buf));
+        zassert_not_null(strstr(buf, ",\"Tp\":-0.01,"), "%s", buf);
+}
+
+/* Like snprintf(), a short buffer gets a terminated prefix and the length
+ * of the whole payload is returned */
+ZTEST(sensors_sample, test_json_truncated)
+{
+        char short_buf[8];
+        int len = sample_to_json(&sample, buf, sizeof(buf));
+
+        zassert_equal(sample_to_json(&sample, short_buf, sizeof(short_buf)), len);
+        zassert_equal(strcmp(short_buf, "{\"CO\":6"), 0, "%s", short_buf);
+}
@@ -0,0 +1,182 @@
+/*
+ * The SCD41 state machines on the emulated sensor: the power mode chosen for
+ * the report interval, the single shots with the sensor powered down in
+ * between, and the ambient pressure only written once it moved by a step.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "../../../sensors/scd41/scd4x_i2c.h"
+#include "../../../sensors/scd41/scd4x_power.h"
+#include "../../../sensors/scd41/scd4x_pressure.h"
+#include "../../../sensors/scd41/sensirion_common.h"
+#include "sensors_test.h"
+
+/* Calls until a step is through; a single shot cycle takes the most */
+#define MAX_STEPS 20
+
+static uint16_t co2;
+static int32_t temperature;
+static int32_t humidity;
+
+static int16_t power_start(uint32_t interval_ms)
+{
+        int16_t error;
+
+        for (uint8_t step = 0; step < MAX_STEPS; step++)
+        {
+                error = scd4x_power_start(interval_ms);
+                if (error != -EAGAIN)
+                {
+                        return error;
+                }
+                k_msleep(MAX(scd4x_power_ms_until_ready(), 1));
+        }
+        return error;
+}
+
+static int16_t power_run(int16_t (*op)(void))
+{
+        int16_t error;
+
+        for (uint8_t step = 0; step < MAX_STEPS; step++)
+        {
+                error = op();
+                if (error != -EAGAIN)
+                {
+                        return error;
+                }
+                k_msleep(MAX(scd4x_power_ms_until_ready(), 1));
+        }
+        return error;
+}
+
+static int16_t power_read(void)
+{
+        return scd4x_power_read(&co2, &temperature, &humidity);
+}
+
+static void *scd41_setup(void)
+{
+        sensors_test_setup();
+        return NULL;
+}
+
+/* Every test starts from an idle, awake sensor */
+static void scd41_before(void *fixture)
+{
+        scd4x_wake_up();
+        scd4x_stop_periodic_measurement();
+        k_msleep(MAX(scd4x_ms_until_idle(), 1));
+        co2 = 0;
+}
+
+ZTEST_SUITE(sensors_scd41, NULL, scd41_setup, scd41_before, NULL, NULL);
+
+/* The cheapest mode that still delivers a sample per interval */
+ZTEST(sensors_scd41, test_power_mode_for_interval)
+{
+        static const struct
+        {
+                uint32_t interval_ms;
+                enum scd4x_power_mode mode;
+        } cases[] = {
+                {SCD4X_PERIODIC_INTERVAL_MS, SCD4X_POWER_PERIODIC},
+                {SCD4X_POWER_LOW_POWER_MIN_MS - 1, SCD4X_POWER_PERIODIC},
+                {SCD4X_POWER_LOW_POWER_MIN_MS, SCD4X_POWER_LOW_POWER},
+                {SCD4X_POWER_SINGLE_SHOT_MIN_MS - 1, SCD4X_POWER_LOW_POWER},
+                {SCD4X_POWER_SINGLE_SHOT_MIN_MS, SCD4X_POWER_SINGLE_SHOT},
+                {SCD4X_POWER_DOWN_MIN_MS, SCD4X_POWER_SINGLE_SHOT},
+        };
+
+        for (uint8_t i = 0; i < ARRAY_SIZE(cases); i++)
+        {
+                zassert_equal(power_start(cases[i].interval_ms), NO_ERROR);
+                zassert_equal(scd4x_power_mode(), cases[i].mode, "interval %u ms",
+                              cases[i].interval_ms);
+                zassert_equal(power_run(power_read), NO_ERROR);
+                zassert_not_equal(co2, 0);
+                scd41_before(NULL);
+        }
+}
+
+/* From SCD4X_POWER_DOWN_MIN_MS the sensor sleeps between shots, and the
+ * first shot after each wake-up is thrown away */
+ZTEST(sensors_scd41, test_power_single_shot_power_down)
+{
+        zassert_equal(power_start(SCD4X_POWER_DOWN_MIN_MS), NO_ERROR);
+        zassert_equal(power_run(power_read), NO_ERROR);
+        zassert_not_equal(co2, 0);
+        zassert_false(scd4x_power_awake());
+
+        co2 = 0;
+        zassert_equal(power_run(power_read), NO_ERROR);
+        zassert_not_equal(co2, 0);
+        zassert_false(scd4x_power_awake());
+}
+
+/* Below SCD4X_POWER_DOWN_MIN_MS the discarded shot would cost more than
+ * staying idle */
+ZTEST(sensors_scd41, test_power_single_shot_idle)
+{
+        zassert_equal(power_start(SCD4X_POWER_SINGLE_SHOT_MIN_MS), NO_ERROR);
+        zassert_equal(power_run(power_read), NO_ERROR);
+        zassert_not_equal(co2, 0);
+        zassert_true(scd4x_power_awake());
+}
+
+ZTEST(sensors_scd41, test_power_suspend_resume)
+{
+        zassert_equal(power_start(SCD4X_PERIODIC_INTERVAL_MS), NO_ERROR);
+        zassert_equal(power_run(scd4x_power_suspend), NO_ERROR);
+        zassert_false(scd4x_power_awake());
+
+        zassert_equal(power_run(scd4x_power_resume), NO_ERROR);
+        zassert_true(scd4x_power_awake());
+        zassert_equal(power_run(power_read), NO_ERROR);
+        zassert_not_equal(co2, 0);
+        zassert_equal(power_run(scd4x_power_suspend), NO_ERROR);
+}
+
+ZTEST(sensors_scd41, test_pressure_step)
+{
+        const uint32_t step_pa = 300;
+
+        zassert_equal(scd4x_pressure_start(0, step_pa), NO_ERROR);
+        k_msleep(MAX(scd4x_ms_until_idle(), 1));
+        zassert_equal(scd4x_pressure_update(), NO_ERROR);
+        zassert_equal(scd4x_pressure_applied(), 0, "written without a pressure");
+
+        zassert_equal(scd4x_pressure_set(SCD4X_PRESSURE_MIN_PA - 1), -EINVAL);
+        zassert_equal(scd4x_pressure_set(SCD4X_PRESSURE_MAX_PA + 1), -EINVAL);
+
+        /* the first pressure is written whatever it is */
+        zassert_ok(scd4x_pressure_set(101325));
+        zassert_equal(scd4x_pressure_update(), NO_ERROR);
+        zassert_equal(scd4x_pressure_applied(), 101325);
+
+        /* while the sensor executes the write, the next one waits */
+        zassert_ok(scd4x_pressure_set(100000));
+        zassert_equal(scd4x_pressure_update(), NO_ERROR);
+        zassert_equal(scd4x_pressure_applied(), 101325);
+        k_msleep(MAX(scd4x_ms_until_idle(), 1));
+
+        /* below the step in either direction */
+        zassert_ok(scd4x_pressure_set(101325 + step_pa - 1));
+        zassert_equal(scd4x_pressure_update(), NO_ERROR);
+        zassert_ok(scd4x_pressure_set(101325 - step_pa + 1));
+        zassert_equal(scd4x_pressure_update(), NO_ERROR);
+        zassert_equal(scd4x_pressure_applied(), 101325);
+
+        zassert_ok(scd4x_pressure_set(101325 - step_pa));
+        zassert_equal(scd4x_pressure_update(), NO_ERROR);
+        zassert_equal(scd4x_pressure_applied(), 101325 - step_pa);
+
+        /* a restart writes the last pressure again */
+        k_msleep(MAX(scd4x_ms_until_idle(), 1));
+        zassert_equal(scd4x_pressure_start(0, step_pa), NO_ERROR);
+        zassert_equal(scd4x_pressure_applied(), 0);
+        k_msleep(MAX(scd4x_ms_until_idle(), 1));
+        zassert_equal(scd4x_pressure_update(), NO_ERROR);
+        zassert_equal(scd4x_pressure_applied(), 101325 - step_pa);
+}
@@ -0,0 +1,181 @@
+/*
+ * The SPS30 state machines on the emulated sensor: whether the duty cycle
+ * sleeps between reports, the averaged reading of a duty-cycled sensor, and
+ * the health state the status register and the fan cleanings lead to.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/emul.h>
+#include "../../../sensors/scd41/sensirion_common.h"
+#include "../../../sensors/sps30/sps30.h"
+#include "../../../sensors/sps30/sps30_duty.h"
+#include "../../../sensors/sps30/sps30_health.h"
+#include "../../../sensors/emul/sensirion_emul.h"
+#include "sensors_test.h"
+
+/* Calls until a duty cycle step is through; a reading of SAMPLES takes the
+ * most */
+#define MAX_STEPS 30
+#define SPINUP_MS 12000
+#define SAMPLES 3
+
+static const struct emul *const sps30_emul = EMUL_DT_GET(DT_NODELABEL(sps30));
+
+static struct sps30_measurement_milli pm;
+
+static int16_t duty_run(int16_t (*op)(void))
+{
+        int16_t error;
+
+        for (uint8_t step = 0; step < MAX_STEPS; step++)
+        {
+                error = op();
+                if (error != -EAGAIN)
+                {
+                        return error;
+                }
+                k_msleep(MAX(sps30_duty_ms_until_ready(), 1));
+        }
+        return error;
+}
+
+static int16_t duty_read(void)
+{
+        return sps30_duty_read(&pm);
+}
+
+static void *sps30_setup(void)
+{
+        sensors_test_setup();
+        return NULL;
+}
+
+/* Every test starts from an idle, awake sensor with a clean status */
+static void sps30_before(void *fixture)
+{
+        sps30_wake_up();
+        sps30_stop_measurement();
+        sps30_set_read_fields(SPS30_FIELDS_ALL);
+        sps30_emul_set_status(sps30_emul, 0);
+        memset(&pm, 0, sizeof(pm));
+}
+
+ZTEST_SUITE(sensors_sps30, NULL, sps30_setup, sps30_before, NULL, NULL);
+
+/* The sensor sleeps between reports unless spin-up and averaging would keep
+ * it running for more than half of the interval */
+ZTEST(sensors_sps30, test_duty_sleeps_when_worth_it)
+{
+        const uint32_t on_ms = SPINUP_MS + SAMPLES * SPS30_MEASUREMENT_INTERVAL_MS;
+
+        zassert_equal(sps30_duty_start(2 * on_ms - 1, SPINUP_MS, SAMPLES), NO_ERROR);
+        zassert_true(sps30_duty_awake(), "sleeping for a short interval");
+        zassert_equal(sps30_duty_ms_until_wake(), -1);
+        zassert_equal(duty_run(duty_read), NO_ERROR);
+        zassert_not_equal(pm.mc_2p5, 0);
+        zassert_equal(duty_run(sps30_duty_suspend), NO_ERROR);
+        zassert_false(sps30_duty_awake());
+
+        sps30_before(NULL);
+        zassert_equal(sps30_duty_start(2 * on_ms, SPINUP_MS, SAMPLES), NO_ERROR);
+        zassert_false(sps30_duty_awake(), "measuring through a long interval");
+        zassert_equal(sps30_duty_ms_until_wake(), on_ms);
+}
+
+/* A duty-cycled reading wakes the sensor, waits out the spin-up, averages
+ * and puts the sensor back to sleep before it is returned */
+ZTEST(sensors_sps30, test_duty_reading)
+{
+        int64_t started;
+
+        zassert_equal(sps30_duty_start(60000, SPINUP_MS, SAMPLES), NO_ERROR);
+        zassert_false(sps30_duty_awake());
+
+        started = k_uptime_get();
+        zassert_equal(duty_run(sps30_duty_wake), NO_ERROR);
+        zassert_true(sps30_duty_awake());
+        zassert_equal(duty_run(duty_read), NO_ERROR);
+        zassert_true(k_uptime_get() - started >= SPINUP_MS + (SAMPLES - 1) * SPS30_MEASUREMENT_INTERVAL_MS,
+                     "reading after %lld ms", k_uptime_get() - started);
+        zassert_not_equal(pm.mc_2p5, 0);
+        zassert_false(sps30_duty_awake());
+
+        /* the next reading wakes the sensor on its own */
+        memset(&pm, 0, sizeof(pm));
+        zassert_equal(duty_run(duty_read), NO_ERROR);
+        zassert_not_equal(pm.mc_2p5, 0);
+        zassert_false(sps30_duty_awake());
+}
+
+/* A continuously measuring sensor sleeps while suspended and measures
+ * again once resumed */
+ZTEST(sensors_sps30, test_duty_suspend_resume)
+{
+        zassert_equal(sps30_duty_start(SPS30_MEASUREMENT_INTERVAL_MS, SPINUP_MS, SAMPLES), NO_ERROR);
+        zassert_equal(duty_run(sps30_duty_suspend), NO_ERROR);
+        zassert_false(sps30_duty_awake());
+
+        zassert_equal(duty_run(sps30_duty_resume), NO_ERROR);
+        zassert_true(sps30_duty_awake());
+        zassert_equal(duty_run(duty_read), NO_ERROR);
+        zassert_not_equal(pm.mc_2p5, 0);
+}
+
+ZTEST(sensors_sps30, test_health_states)
+{
+        zassert_equal(sps30_health_start(), NO_ERROR);
+        zassert_equal(sps30_health_state(), SPS30_HEALTH_UNKNOWN);
+        zassert_true(sps30_health_reading_valid(), "unchecked readings refused");
+
+        zassert_equal(sps30_health_check(), NO_ERROR);
+        zassert_equal(sps30_health_state(), SPS30_HEALTH_OK);
+        zassert_true(sps30_health_reading_valid());
+
+        sps30_emul_set_status(sps30_emul, SPS30_DEVICE_STATUS_FAN_SPEED_WARNING);
+        zassert_equal(sps30_health_check(), NO_ERROR);
+        zassert_equal(sps30_health_state(), SPS30_HEALTH_DEGRADED);
+        zassert_false(sps30_health_reading_valid());
+        zassert_equal(sps30_health_status(), SPS30_DEVICE_STATUS_FAN_SPEED_WARNING);
+
+        sps30_emul_set_status(sps30_emul, SPS30_DEVICE_STATUS_LASER_ERROR_MASK);
+        zassert_equal(sps30_health_check(), NO_ERROR);
+        zassert_equal(sps30_health_state(), SPS30_HEALTH_FAULT);
+        zassert_false(sps30_health_reading_valid());
+
+        /* the flags clear themselves once the condition is gone */
+        sps30_emul_set_status(sps30_emul, 0);
+        zassert_equal(sps30_health_check(), NO_ERROR);
+        zassert_equal(sps30_health_state(), SPS30_HEALTH_OK);
+        zassert_equal(strcmp(sps30_health_state_str(sps30_health_state()), "ok"), 0);
+}
+
+/* A fan speed warning asks for a cleaning, at most once per
+ * SPS30_HEALTH_CLEAN_RETRY_MS; readings during it and until the fan settled
+ * are not used */
+ZTEST(sensors_sps30, test_health_clean)
+{
+        zassert_equal(sps30_health_start(), NO_ERROR);
+        zassert_equal(sps30_start_measurement(), NO_ERROR);
+
+        sps30_emul_set_status(sps30_emul, SPS30_DEVICE_STATUS_FAN_SPEED_WARNING);
+        zassert_equal(sps30_health_check(), NO_ERROR);
+        zassert_true(sps30_health_clean_wanted());
+
+        zassert_equal(sps30_health_clean(), NO_ERROR);
+        zassert_false(sps30_health_clean_wanted());
+        zassert_equal(sps30_health_state(), SPS30_HEALTH_CLEANING);
+        zassert_false(sps30_health_reading_valid());
+
+        k_msleep(SPS30_HEALTH_CLEAN_MS + SPS30_HEALTH_CLEAN_SETTLE_MS);
+        zassert_equal(sps30_health_state(), SPS30_HEALTH_DEGRADED);
+
+        /* the warning persists, but the cleaning is not repeated yet */
+        zassert_equal(sps30_health_check(), NO_ERROR);
+        zassert_false(sps30_health_clean_wanted());
+
+        k_msleep(SPS30_HEALTH_CLEAN_RETRY_MS);
+        zassert_equal(sps30_health_check(), NO_ERROR);
+        zassert_true(sps30_health_clean_wanted());
+}